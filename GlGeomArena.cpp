@@ -0,0 +1,303 @@
+/*
+* GlGeomArena.cpp - Version 0.9 - October 18, 2026
+*
+* Shared large VAO/VBO/EBO pools for GlGeomShape objects.
+*   See GlGeomArena.h for more information.
+*
+* An addition to the software accompanying POSSIBLE SECOND EDITION TO the book
+*		3D Computer Graphics: A Mathematical Introduction with OpenGL,
+*		by S. Buss, Cambridge University Press, 2003.
+*   Not part of the book's software, and not written by its author.
+*
+* Software is "as-is" and carries no warranty.  It may be used without
+*   restriction, but if you modify it, please change the filenames to
+*   prevent confusion between different versions.
+* Web page of the book's software: http://math.ucsd.edu/~sbuss/MathCG2
+*/
+
+// Use the static library (so glew32.dll is not needed):
+#define GLEW_STATIC
+#include <GL/glew.h>
+#include <GLFW/glfw3.h>
+
+#include "GlGeomArena.h"
+#include "GlGeomBase.h"
+#include "GlGeomBudget.h"
+#include "GlGeomStateCache.h"
+#include "assert.h"
+#include <stdio.h>
+#include <algorithm>
+
+GlGeomArena::GlGeomArena(int initialVertices, int initialElements)
+{
+    initVertices = initialVertices > 0 ? initialVertices : 1;
+    initElements = initialElements > 0 ? initialElements : 1;
+}
+
+// Shapes hold a pointer to their arena, so none may be left when it is deleted.
+GlGeomArena::~GlGeomArena()
+{
+    assert(GetNumAllocations() == 0 && "Shapes must be deleted, or leave the arena, before the arena is deleted!");
+    for (Pool& pool : pools) {
+        GlGeomStateCache::DeleteVertexArray(pool.vao);
+        glDeleteBuffers(1, &pool.vbo);
+        glDeleteBuffers(1, &pool.ebo);
+    }
+    if (GlGeomBudget::Default() != nullptr) {
+        GlGeomBudget::Default()->RecordRelease(this);
+    }
+}
+
+// Tell the budget (see GlGeomBudget.h) the total size of the pools' buffers.
+void GlGeomArena::RecordBytes()
+{
+    if (GlGeomBudget::Default() != nullptr) {
+        GlGeomBudget::Default()->RecordAllocation(this, GetCapacityBytes());
+    }
+}
+
+int GlGeomArena::Allocate(const GlGeomVertexLayout& layout,
+    unsigned int posLoc, unsigned int normalLoc, unsigned int texcoordsLoc,
+    int numVertices, int numElements)
+{
+    int poolNum = FindOrCreatePool(layout, posLoc, normalLoc, texcoordsLoc);
+    Pool& pool = pools[poolNum];
+
+    Allocation alloc;
+    alloc.pool = poolNum;
+    alloc.numVertices = numVertices;
+    alloc.numElements = numElements;
+    alloc.firstVertex = AllocRange(pool.freeVertices, numVertices);
+    if (alloc.firstVertex < 0) {
+        GrowVertices(pool, numVertices);
+        alloc.firstVertex = AllocRange(pool.freeVertices, numVertices);
+    }
+    alloc.firstElement = AllocRange(pool.freeElements, numElements);
+    if (alloc.firstElement < 0) {
+        GrowElements(pool, numElements);
+        alloc.firstElement = AllocRange(pool.freeElements, numElements);
+    }
+    assert(alloc.firstVertex >= 0 && alloc.firstElement >= 0);
+
+    // Reuse an unused allocation id if possible
+    for (int i = 0; i < (int)allocs.size(); i++) {
+        if (allocs[i].pool < 0) {
+            allocs[i] = alloc;
+            return i;
+        }
+    }
+    allocs.push_back(alloc);
+    return (int)allocs.size() - 1;
+}
+
+void GlGeomArena::Free(int allocId)
+{
+    assert(allocId >= 0 && allocId < (int)allocs.size() && allocs[allocId].pool >= 0);
+    Allocation& alloc = allocs[allocId];
+    Pool& pool = pools[alloc.pool];
+    FreeRange(pool.freeVertices, alloc.firstVertex, alloc.numVertices);
+    FreeRange(pool.freeElements, alloc.firstElement, alloc.numElements);
+    alloc.pool = -1;
+}
+
+int GlGeomArena::FindOrCreatePool(const GlGeomVertexLayout& layout,
+    unsigned int posLoc, unsigned int normalLoc, unsigned int texcoordsLoc)
+{
+    char key[80];
+    snprintf(key, sizeof(key), "%d %d %d|%d %d %d|%d %d",
+        (int)posLoc, (int)normalLoc, (int)texcoordsLoc,
+        (int)layout.format.posFormat, (int)layout.format.normalFormat, (int)layout.format.texCoordFormat,
+        (int)layout.useNormals, (int)layout.useTexCoords);
+    for (int i = 0; i < (int)pools.size(); i++) {
+        if (pools[i].key == key) {
+            return i;
+        }
+    }
+
+    Pool pool;
+    pool.key = key;
+    pool.stride = layout.stride;
+    pool.vertexCapacity = initVertices;
+    pool.elementCapacity = initElements;
+    pool.freeVertices.push_back(Range{ 0, initVertices });
+    pool.freeElements.push_back(Range{ 0, initElements });
+
+    glGenVertexArrays(1, &pool.vao);
+    glGenBuffers(1, &pool.vbo);
+    glGenBuffers(1, &pool.ebo);
+    GlGeomStateCache::BindVertexArray(pool.vao);
+    glBindBuffer(GL_ARRAY_BUFFER, pool.vbo);
+    glBufferData(GL_ARRAY_BUFFER, (GLsizeiptr)pool.vertexCapacity * pool.stride, 0, GL_STATIC_DRAW);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, pool.ebo);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, (GLsizeiptr)pool.elementCapacity * sizeof(unsigned int), 0, GL_STATIC_DRAW);
+    GlGeomBase::SetVertexAttribPointers(layout, posLoc, normalLoc, texcoordsLoc);
+    GlGeomStateCache::BindVertexArray(0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    pools.push_back(pool);
+    RecordBytes();
+    return (int)pools.size() - 1;
+}
+
+// First fit.  Returns the start of the range, or -1 if there is no room.
+int GlGeomArena::AllocRange(std::vector<Range>& freeList, int count)
+{
+    for (int i = 0; i < (int)freeList.size(); i++) {
+        if (freeList[i].count >= count) {
+            int first = freeList[i].first;
+            freeList[i].first += count;
+            freeList[i].count -= count;
+            if (freeList[i].count == 0) {
+                freeList.erase(freeList.begin() + i);
+            }
+            return first;
+        }
+    }
+    return -1;
+}
+
+// Return a range to the free list, merging with its neighbors.
+void GlGeomArena::FreeRange(std::vector<Range>& freeList, int first, int count)
+{
+    if (count == 0) {
+        return;
+    }
+    int i = 0;
+    while (i < (int)freeList.size() && freeList[i].first < first) {
+        i++;
+    }
+    freeList.insert(freeList.begin() + i, Range{ first, count });
+    if (i + 1 < (int)freeList.size() && first + count == freeList[i + 1].first) {
+        freeList[i].count += freeList[i + 1].count;
+        freeList.erase(freeList.begin() + i + 1);
+    }
+    if (i > 0 && freeList[i - 1].first + freeList[i - 1].count == first) {
+        freeList[i - 1].count += freeList[i].count;
+        freeList.erase(freeList.begin() + i);
+    }
+}
+
+// Enlarge a buffer, keeping its contents and its name (so the VAO stays valid).
+//    The copy targets are used so that the VAO's element buffer binding is not disturbed.
+void GlGeomArena::GrowBuffer(unsigned int buffer, long long oldBytes, long long newBytes)
+{
+    unsigned int tempBuffer;
+    glGenBuffers(1, &tempBuffer);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, tempBuffer);
+    glBufferData(GL_COPY_WRITE_BUFFER, (GLsizeiptr)oldBytes, 0, GL_STREAM_COPY);
+    glBindBuffer(GL_COPY_READ_BUFFER, buffer);
+    glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, 0, 0, (GLsizeiptr)oldBytes);
+    glBufferData(GL_COPY_READ_BUFFER, (GLsizeiptr)newBytes, 0, GL_STATIC_DRAW);
+    glCopyBufferSubData(GL_COPY_WRITE_BUFFER, GL_COPY_READ_BUFFER, 0, 0, (GLsizeiptr)oldBytes);
+    glBindBuffer(GL_COPY_READ_BUFFER, 0);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+    glDeleteBuffers(1, &tempBuffer);
+}
+
+void GlGeomArena::GrowVertices(Pool& pool, int minFree)
+{
+    int oldCapacity = pool.vertexCapacity;
+    int newCapacity = std::max(2 * oldCapacity, oldCapacity + minFree);
+    GrowBuffer(pool.vbo, (long long)oldCapacity * pool.stride, (long long)newCapacity * pool.stride);
+    pool.vertexCapacity = newCapacity;
+    FreeRange(pool.freeVertices, oldCapacity, newCapacity - oldCapacity);
+    RecordBytes();
+}
+
+void GlGeomArena::GrowElements(Pool& pool, int minFree)
+{
+    int oldCapacity = pool.elementCapacity;
+    int newCapacity = std::max(2 * oldCapacity, oldCapacity + minFree);
+    GrowBuffer(pool.ebo, (long long)oldCapacity * sizeof(unsigned int), (long long)newCapacity * sizeof(unsigned int));
+    pool.elementCapacity = newCapacity;
+    FreeRange(pool.freeElements, oldCapacity, newCapacity - oldCapacity);
+    RecordBytes();
+}
+
+// Pack the allocations of each pool together at the start of the pool.
+//    The pool's data is copied to a temporary buffer, and then each
+//    allocation is copied back to its new position.
+//    Element values are relative to the base vertex, so do not change.
+void GlGeomArena::Defragment()
+{
+    for (int p = 0; p < (int)pools.size(); p++) {
+        Pool& pool = pools[p];
+        std::vector<int> live;
+        for (int i = 0; i < (int)allocs.size(); i++) {
+            if (allocs[i].pool == p) {
+                live.push_back(i);
+            }
+        }
+
+        for (int pass = 0; pass < 2; pass++) {
+            bool vertexPass = (pass == 0);
+            unsigned int buffer = vertexPass ? pool.vbo : pool.ebo;
+            long long unitBytes = vertexPass ? pool.stride : (long long)sizeof(unsigned int);
+            long long bufferBytes = unitBytes * (vertexPass ? pool.vertexCapacity : pool.elementCapacity);
+
+            std::sort(live.begin(), live.end(), [this, vertexPass](int a, int b) {
+                return vertexPass ? (allocs[a].firstVertex < allocs[b].firstVertex)
+                    : (allocs[a].firstElement < allocs[b].firstElement);
+            });
+
+            unsigned int tempBuffer;
+            glGenBuffers(1, &tempBuffer);
+            glBindBuffer(GL_COPY_WRITE_BUFFER, tempBuffer);
+            glBufferData(GL_COPY_WRITE_BUFFER, (GLsizeiptr)bufferBytes, 0, GL_STREAM_COPY);
+            glBindBuffer(GL_COPY_READ_BUFFER, buffer);
+            glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, 0, 0, (GLsizeiptr)bufferBytes);
+
+            int packed = 0;
+            for (int id : live) {
+                int& first = vertexPass ? allocs[id].firstVertex : allocs[id].firstElement;
+                int count = vertexPass ? allocs[id].numVertices : allocs[id].numElements;
+                if (first != packed && count > 0) {
+                    glCopyBufferSubData(GL_COPY_WRITE_BUFFER, GL_COPY_READ_BUFFER,
+                        (GLintptr)(first * unitBytes), (GLintptr)(packed * unitBytes), (GLsizeiptr)(count * unitBytes));
+                }
+                first = packed;
+                packed += count;
+            }
+            glBindBuffer(GL_COPY_READ_BUFFER, 0);
+            glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+            glDeleteBuffers(1, &tempBuffer);
+
+            std::vector<Range>& freeList = vertexPass ? pool.freeVertices : pool.freeElements;
+            int capacity = vertexPass ? pool.vertexCapacity : pool.elementCapacity;
+            freeList.clear();
+            if (packed < capacity) {
+                freeList.push_back(Range{ packed, capacity - packed });
+            }
+        }
+    }
+}
+
+int GlGeomArena::GetNumAllocations() const
+{
+    int count = 0;
+    for (const Allocation& alloc : allocs) {
+        count += (alloc.pool >= 0) ? 1 : 0;
+    }
+    return count;
+}
+
+long long GlGeomArena::GetCapacityBytes() const
+{
+    long long total = 0;
+    for (const Pool& pool : pools) {
+        total += (long long)pool.vertexCapacity * pool.stride + (long long)pool.elementCapacity * sizeof(unsigned int);
+    }
+    return total;
+}
+
+long long GlGeomArena::GetUsedBytes() const
+{
+    long long total = 0;
+    for (const Allocation& alloc : allocs) {
+        if (alloc.pool >= 0) {
+            total += (long long)alloc.numVertices * pools[alloc.pool].stride
+                + (long long)alloc.numElements * sizeof(unsigned int);
+        }
+    }
+    return total;
+}
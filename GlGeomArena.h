@@ -0,0 +1,121 @@
+/*
+* GlGeomArena.h - Version 0.9 - October 18, 2026
+*
+* A GlGeomArena holds the vertex and element data of many GlGeomShape
+*    objects in a few large buffers.
+*    There is one "pool" for each vertex layout (vertex format and attribute
+*    locations). Each pool has a single VAO, a single large VBO and a single
+*    large EBO. Each shape is given a range of vertices and a range of elements
+*    in a pool, and is drawn with glDrawElementsBaseVertex.
+*    All shapes in a pool are rendered with the same VAO, so there is no
+*    switching of VAO's between them.
+*
+* How to use:
+*    * Create a GlGeomArena (after the OpenGL context is created).
+*    * Call SetArena() on the GlGeomShape objects before calling their
+*          InitializeAttribLocations().
+*    * Shapes in an arena do not use the GlGeomRegistry.
+*    * Freed ranges are reused. Call Defragment() to pack all the ranges
+*          together, for instance after many shapes have been deleted or re-meshed.
+*    * The arena must outlive the shapes that use it: the destructor asserts
+*          that no shape still has data in the arena.
+*
+* An addition to the software accompanying POSSIBLE SECOND EDITION TO the book
+*		3D Computer Graphics: A Mathematical Introduction with OpenGL,
+*		by S. Buss, Cambridge University Press, 2003.
+*   Not part of the book's software, and not written by its author.
+*
+* Software is "as-is" and carries no warranty.  It may be used without
+*   restriction, but if you modify it, please change the filenames to
+*   prevent confusion between different versions.
+* Web page of the book's software: http://math.ucsd.edu/~sbuss/MathCG2
+*/
+
+#pragma once
+#ifndef GLGEOM_ARENA_H
+#define GLGEOM_ARENA_H
+
+#include <string>
+#include <vector>
+#include "GlGeomVertexFormat.h"
+
+class GlGeomArena
+{
+public:
+    // Initial sizes of each pool: number of vertices and number of elements.
+    //    Pools grow as needed (doubling in size).
+    GlGeomArena(int initialVertices = 16384, int initialElements = 65536);
+    ~GlGeomArena();
+
+    GlGeomArena(const GlGeomArena&) = delete;
+    GlGeomArena& operator=(const GlGeomArena&) = delete;
+
+    // Allocate(): Get ranges for numVertices vertices and numElements elements
+    //    in the pool for the given layout and attribute locations.
+    //    Returns an allocation id (non-negative).
+    int Allocate(const GlGeomVertexLayout& layout,
+        unsigned int posLoc, unsigned int normalLoc, unsigned int texcoordsLoc,
+        int numVertices, int numElements);
+    void Free(int allocId);
+
+    // Move all allocations to the start of their pools, so that the free
+    //    space is in one piece. Allocation ids stay valid.
+    void Defragment();
+
+    // Information on an allocation.
+    //    The base vertex and first element may be changed by Defragment(),
+    //    but the VAO, VBO and EBO never change.
+    unsigned int GetVAO(int allocId) const { return pools[allocs[allocId].pool].vao; }
+    unsigned int GetVBO(int allocId) const { return pools[allocs[allocId].pool].vbo; }
+    unsigned int GetEBO(int allocId) const { return pools[allocs[allocId].pool].ebo; }
+    int GetBaseVertex(int allocId) const { return allocs[allocId].firstVertex; }
+    int GetFirstElement(int allocId) const { return allocs[allocId].firstElement; }
+    int GetNumVertices(int allocId) const { return allocs[allocId].numVertices; }
+    int GetNumElements(int allocId) const { return allocs[allocId].numElements; }
+    int GetStride(int allocId) const { return pools[allocs[allocId].pool].stride; }
+
+    // Statistics
+    int GetNumPools() const { return (int)pools.size(); }
+    int GetNumAllocations() const;
+    long long GetCapacityBytes() const;     // Total size of all VBO's and EBO's
+    long long GetUsedBytes() const;         // Total size of all live allocations
+
+private:
+    struct Range {
+        int first;
+        int count;
+    };
+    struct Pool {
+        std::string key;            // Attribute locations and vertex format
+        unsigned int vao;
+        unsigned int vbo;
+        unsigned int ebo;
+        int stride;                 // Bytes per vertex
+        int vertexCapacity;         // In vertices
+        int elementCapacity;        // In elements
+        std::vector<Range> freeVertices;    // Sorted by first
+        std::vector<Range> freeElements;    // Sorted by first
+    };
+    struct Allocation {
+        int pool;                   // -1 if the allocation id is not in use
+        int firstVertex;
+        int numVertices;
+        int firstElement;
+        int numElements;
+    };
+    std::vector<Pool> pools;
+    std::vector<Allocation> allocs;
+    int initVertices;
+    int initElements;
+
+    int FindOrCreatePool(const GlGeomVertexLayout& layout,
+        unsigned int posLoc, unsigned int normalLoc, unsigned int texcoordsLoc);
+    static int AllocRange(std::vector<Range>& freeList, int count);
+    static void FreeRange(std::vector<Range>& freeList, int first, int count);
+    static void GrowBuffer(unsigned int buffer, long long oldBytes, long long newBytes);
+    void GrowVertices(Pool& pool, int minFree);
+    void GrowElements(Pool& pool, int minFree);
+    void RecordBytes();
+};
+
+#endif  // GLGEOM_ARENA_H
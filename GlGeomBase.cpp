@@ -21,13 +21,54 @@
 
 
 #include "GlGeomBase.h"
+#include "GlGeomRegistry.h"
+#include "GlGeomArena.h"
+#include "GlGeomBudget.h"
+#include "GlGeomStagingRing.h"
+#include "GlGeomMesh.h"
+#include "GlGeomMeshCache.h"
+#include "GlGeomMeshlets.h"
+#include "GlGeomStateCache.h"
 #include "assert.h"
+#include <stdio.h>
+#include <string.h>
+#include <stddef.h>
+#include <utility>
+#include <vector>
 
 // Use the static library (so glew32.dll is not needed):
 #define GLEW_STATIC
 #include <GL/glew.h> 
 #include <GLFW/glfw3.h>
 
+namespace {
+    bool DSAEnabled = true;
+
+    // Set the format of one attribute of a VAO, with direct state access.
+    void SetAttribFormat(unsigned int vao, unsigned int loc, unsigned int binding,
+        int size, GLenum type, GLboolean normalized, int relativeOffset)
+    {
+        glVertexArrayAttribFormat(vao, loc, size, type, normalized, relativeOffset);
+        glVertexArrayAttribBinding(vao, loc, binding);
+        glEnableVertexArrayAttrib(vao, loc);
+    }
+}
+
+bool GlGeomBase::IsDSASupported()
+{
+    return GLEW_VERSION_4_5 || GLEW_ARB_direct_state_access;
+}
+
+void GlGeomBase::SetDSAEnabled(bool enabled)
+{
+    DSAEnabled = enabled;
+}
+
+bool GlGeomBase::UseDSA()
+{
+    return DSAEnabled && IsDSASupported();
+}
+
 void GlGeomBase::ReInitializeAttribLocations()
 {
     InitializeAttribLocations(posLoc, normalLoc, texcoordsLoc);
@@ -36,67 +77,577 @@ void GlGeomBase::ReInitializeAttribLocations()
 void GlGeomBase::InitializeAttribLocations(
     unsigned int pos_loc, unsigned int normal_loc, unsigned int texcoords_loc)
 {
+    assert(!loadPending && "The shape is still being loaded by a GlGeomLoader!");
     posLoc = pos_loc;
     normalLoc = normal_loc;
     texcoordsLoc = texcoords_loc;
+    evicted = false;
+    meshState = MeshLoaded;         // All paths below leave the current mesh in the VBO and EBO
+    meshletsDirty = true;           // The vertex numbering depends on whether texture coordinates are used
+
+    positionVaoDirty = true;
 
-    // Generate Vertex Array Object and Buffer Objects, not already done.
+    vertexLayout = CalcVertexLayout();
+    int numVertices = UseTexCoords() ? GetNumVerticesTexCoords() : GetNumVerticesNoTexCoords();
+
+    // In an arena: get new ranges (the old ranges are freed first, so may be reused).
+    if (theArena != nullptr) {
+        ReleaseBuffers();
+        arenaAllocId = theArena->Allocate(vertexLayout, posLoc, normalLoc, texcoordsLoc,
+            numVertices, GetNumEboElements());
+        theVAO = theArena->GetVAO(arenaAllocId);
+        theVBO = theArena->GetVBO(arenaAllocId);
+        theEBO = theArena->GetEBO(arenaAllocId);
+        usesDSA = false;            // The arena sets up its own buffers
+        CalcVBOandEBO_Base();
+        return;
+    }
+
+    // Use the shared VAO, VBO and EBO if another object already has the same mesh.
+    std::string meshKey = GlGeomRegistry::IsEnabled() ? GetMeshKey() : std::string();
+    if (IsShared()) {
+        if (meshKey == sharedKey) {
+            return;             // Already using the shared mesh
+        }
+        ReleaseBuffers();       // Drop the previous shared mesh
+    }
+    if (!meshKey.empty()) {
+        unsigned int vao, vbo, ebo;
+        if (GlGeomRegistry::Acquire(meshKey, &vao, &vbo, &ebo)) {
+            ReleaseBuffers();
+            theVAO = vao;
+            theVBO = vbo;
+            theEBO = ebo;
+            sharedKey = meshKey;
+            return;
+        }
+    }
+
+    long long vboBytes = (long long)vertexLayout.stride * numVertices;
+    long long eboBytes = (long long)GetNumEboElements() * sizeof(unsigned int);
     if (theVAO == 0) {
+        usesDSA = UseDSA();
+    }
+    if (usesDSA) {
+        CreateBuffersDSA(vboBytes, eboBytes);
+    }
+    else {
+        // Generate Vertex Array Object and Buffer Objects, not already done.
+        if (theVAO == 0) {
+            glGenVertexArrays(1, &theVAO);
+            glGenBuffers(1, &theVBO);
+            glGenBuffers(1, &theEBO);
+        }
+
+        // Link the VBO and EBO to the VAO, and request OpenGL to
+        //   allocate memory for them.
+        // When re-meshing, the existing memory is reused if it is large enough.
+        GlGeomStateCache::BindVertexArray(theVAO);
+        glBindBuffer(GL_ARRAY_BUFFER, theVBO);
+        if (vboBytes > vboCapacity) {
+            glBufferData(GL_ARRAY_BUFFER, (GLsizeiptr)vboBytes, 0, GL_STATIC_DRAW);
+            vboCapacity = vboBytes;
+        }
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, theEBO);
+        if (eboBytes > eboCapacity) {
+            glBufferData(GL_ELEMENT_ARRAY_BUFFER, (GLsizeiptr)eboBytes, 0, GL_STATIC_DRAW);
+            eboCapacity = eboBytes;
+        }
+        SetVertexAttribPointers();
+    }
+
+    CalcVBOandEBO_Base();
+
+    // Make the new mesh available to other objects (the registry now owns the buffers).
+    if (!meshKey.empty()) {
+        if (Budget() != nullptr) {
+            Budget()->RecordRelease(this);
+        }
+        GlGeomRegistry::Register(meshKey, theVAO, theVBO, theEBO, vboCapacity + eboCapacity);
+        sharedKey = meshKey;
+    }
+    else {
+        RecordBuffers();
+    }
+}
+
+// The vertex layout for the shape's current mesh.
+//    The vertices in an arena are always interleaved, since all its shapes share one VAO.
+GlGeomVertexLayout GlGeomBase::CalcVertexLayout() const
+{
+    GlGeomVertexFormat format = vertexFormat;
+    format.splitStreams = format.splitStreams && (theArena == nullptr);
+    GlGeomVertexLayout layout;
+    layout.Set(format, UseNormals(), UseTexCoords(), NormalsEqualPositions(), FitsUnitCube());
+    layout.SetNumVertices(UseTexCoords() ? GetNumVerticesTexCoords() : GetNumVerticesNoTexCoords());
+    return layout;
+}
+
+// Tell the budget (see GlGeomBudget.h) the size of the VBO and EBO owned by this object.
+void GlGeomBase::RecordBuffers()
+{
+    GlGeomBudget* budget = GlGeomBudget::Default();
+    if (budget != nullptr && theVAO != 0 && !IsShared() && theArena == nullptr) {
+        budget->RecordAllocation(this, vboCapacity + eboCapacity, evictable ? this : nullptr);
+        inBudget = true;
+    }
+}
+
+// The budget, if this object has recorded buffers with it.  Other objects never use
+//    the budget: they may be temporary objects made on a GlGeomLoader's thread (e.g.,
+//    by GlGeomSphereLOD::CalcVboAndEbo()), and the budget is not thread safe.
+GlGeomBudget* GlGeomBase::Budget() const
+{
+    return inBudget ? GlGeomBudget::Default() : nullptr;
+}
+
+void GlGeomBase::SetEvictable(bool isEvictable)
+{
+    evictable = isEvictable;
+    RecordBuffers();
+}
+
+// Called by the budget: release the VAO, VBO and EBO of a mesh not used recently.
+//    If vboCopy is not null, the mesh is first read back into vboCopy and eboCopy
+//    (unless the buffers are out of date).  The next PreRender() loads the mesh again.
+void GlGeomBase::EvictBuffers(std::vector<unsigned char>* vboCopy, std::vector<unsigned int>* eboCopy)
+{
+    assert(!IsShared() && theArena == nullptr && !loadPending);
+    if (vboCopy != nullptr && meshState == MeshLoaded) {
+        int numVertices = UseTexCoords() ? GetNumVerticesTexCoords() : GetNumVerticesNoTexCoords();
+        long long vboBytes = (long long)numVertices * vertexLayout.stride;
+        long long eboBytes = (long long)GetNumEboElements() * sizeof(unsigned int);
+        vboCopy->resize((size_t)vboBytes);
+        eboCopy->resize(GetNumEboElements());
+        if (usesDSA) {
+            glGetNamedBufferSubData(theVBO, 0, (GLsizeiptr)vboBytes, vboCopy->data());
+            glGetNamedBufferSubData(theEBO, 0, (GLsizeiptr)eboBytes, eboCopy->data());
+        }
+        else {
+            glBindBuffer(GL_COPY_READ_BUFFER, theVBO);
+            glGetBufferSubData(GL_COPY_READ_BUFFER, 0, (GLsizeiptr)vboBytes, vboCopy->data());
+            glBindBuffer(GL_COPY_READ_BUFFER, theEBO);
+            glGetBufferSubData(GL_COPY_READ_BUFFER, 0, (GLsizeiptr)eboBytes, eboCopy->data());
+            glBindBuffer(GL_COPY_READ_BUFFER, 0);
+        }
+    }
+    ReleaseBuffers();
+    meshState = MeshDirty;
+    evicted = true;
+}
+
+// Create the VAO, VBO and EBO with direct state access: nothing is bound.
+//    Buffer storage cannot be resized, so when re-meshing a VBO or EBO
+//    which is too small is replaced by a new buffer.
+void GlGeomBase::CreateBuffersDSA(long long vboBytes, long long eboBytes)
+{
+    if (theVAO == 0) {
+        glCreateVertexArrays(1, &theVAO);
+    }
+    if (vboBytes > vboCapacity) {
+        if (theVBO != 0) {
+            glDeleteBuffers(1, &theVBO);
+        }
+        glCreateBuffers(1, &theVBO);
+        glNamedBufferStorage(theVBO, (GLsizeiptr)vboBytes, 0, GL_MAP_WRITE_BIT);
+        vboCapacity = vboBytes;
+    }
+    if (eboBytes > eboCapacity) {
+        if (theEBO != 0) {
+            glDeleteBuffers(1, &theEBO);
+        }
+        glCreateBuffers(1, &theEBO);
+        glNamedBufferStorage(theEBO, (GLsizeiptr)eboBytes, 0, GL_MAP_WRITE_BIT);
+        eboCapacity = eboBytes;
+    }
+    glVertexArrayElementBuffer(theVAO, theEBO);
+    SetVertexArrayFormats(theVAO, theVBO, vertexLayout, posLoc, normalLoc, texcoordsLoc);
+}
+
+// Start loading the mesh on a GlGeomLoader's thread: the current buffers are released,
+//    and the vertex layout is set up so that the loader can size the new VBO and EBO.
+//    The mesh is never shared or put in an arena, since the registry and the arena
+//    are only used from the render thread.
+void GlGeomBase::BeginAsyncLoad(unsigned int pos_loc, unsigned int normal_loc, unsigned int texcoords_loc)
+{
+    assert(!loadPending && "The shape is already being loaded!");
+    assert(theArena == nullptr && "Shapes in an arena cannot be loaded by a GlGeomLoader!");
+    ReleaseBuffers();
+    if (Budget() != nullptr) {
+        Budget()->DropCpuCopy(this);
+    }
+    posLoc = pos_loc;
+    normalLoc = normal_loc;
+    texcoordsLoc = texcoords_loc;
+    evicted = false;
+    meshState = MeshLoaded;         // The loader calculates the current mesh
+    meshletsDirty = true;
+    positionVaoDirty = true;
+    vertexLayout = CalcVertexLayout();
+    loadPending = true;
+}
+
+// Take over the VBO and EBO filled by the loader, once its fence has signaled.
+//    VAOs are not shared between contexts, so the VAO is made here, on the render thread.
+void GlGeomBase::FinishAsyncLoad(unsigned int vbo, unsigned int ebo, long long vboBytes, long long eboBytes)
+{
+    assert(loadPending && theVAO == 0);
+    theVBO = vbo;
+    theEBO = ebo;
+    vboCapacity = vboBytes;
+    eboCapacity = eboBytes;
+    usesDSA = UseDSA();
+    if (usesDSA) {
+        glCreateVertexArrays(1, &theVAO);
+        glVertexArrayElementBuffer(theVAO, theEBO);
+        SetVertexArrayFormats(theVAO, theVBO, vertexLayout, posLoc, normalLoc, texcoordsLoc);
+    }
+    else {
         glGenVertexArrays(1, &theVAO);
-        glGenBuffers(1, &theVBO);
-        glGenBuffers(1, &theEBO);
+        GlGeomStateCache::BindVertexArray(theVAO);
+        glBindBuffer(GL_ARRAY_BUFFER, theVBO);
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, theEBO);
+        SetVertexAttribPointers();
+        GlGeomStateCache::BindVertexArray(0);
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
     }
+    loadPending = false;
+    RecordBuffers();
+}
 
-    // Link the VBO and EBO to the VAO, and request OpenGL to
-    //   allocate memory for them.
-    glBindVertexArray(theVAO);
-    glBindBuffer(GL_ARRAY_BUFFER, theVBO);
-    int numVertices = UseTexCoords() ? GetNumVerticesTexCoords() : GetNumVerticesNoTexCoords();
-    glBufferData(GL_ARRAY_BUFFER, StrideVal() * numVertices * sizeof(float), 0, GL_STATIC_DRAW);
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, theEBO);
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER, GetNumElements() * sizeof(unsigned int), 0, GL_STATIC_DRAW);
-    glVertexAttribPointer(posLoc, 3, GL_FLOAT, GL_FALSE, StrideVal() * sizeof(float), (void*)0);
+// Take over the VAO, VBO and EBO just loaded into another object with the same mesh
+//    (see GlGeomLoader::Remesh()).  The old buffers are released only now, so the old
+//    mesh is rendered until the new one is ready.  The other object is left with no buffers.
+void GlGeomBase::AdoptBuffers(GlGeomBase& loaded)
+{
+    assert(!loaded.loadPending && !loaded.IsShared() && loaded.theArena == nullptr && theArena == nullptr);
+    ReleaseBuffers();
+    if (Budget() != nullptr) {
+        Budget()->DropCpuCopy(this);
+    }
+    if (loaded.Budget() != nullptr) {
+        loaded.Budget()->RecordRelease(&loaded);
+    }
+    theVAO = loaded.theVAO;
+    theVBO = loaded.theVBO;
+    theEBO = loaded.theEBO;
+    vboCapacity = loaded.vboCapacity;
+    eboCapacity = loaded.eboCapacity;
+    usesDSA = loaded.usesDSA;
+    vertexLayout = loaded.vertexLayout;
+    evicted = false;
+    meshState = MeshLoaded;
+    meshletsDirty = true;
+    positionVaoDirty = true;
+    loaded.theVAO = 0;
+    loaded.theVBO = 0;
+    loaded.theEBO = 0;
+    loaded.vboCapacity = 0;
+    loaded.eboCapacity = 0;
+    RecordBuffers();
+}
+
+// The mesh key has the form "<shape key>|<attribute locations>|<vertex formats>"
+std::string GlGeomBase::GetMeshKey() const
+{
+    std::string shapeKey = GetShapeKey();
+    if (shapeKey.empty()) {
+        return shapeKey;
+    }
+    char suffix[80];
+    snprintf(suffix, sizeof(suffix), "|%d %d %d|%d %d %d %d",
+        (int)posLoc, (int)normalLoc, (int)texcoordsLoc,
+        (int)vertexLayout.format.posFormat, (int)vertexLayout.format.normalFormat,
+        (int)vertexLayout.format.texCoordFormat, (int)vertexLayout.splitStreams);
+    return shapeKey + suffix;
+}
+
+// Release the VAO, VBO and EBO: either free the ranges in the arena,
+//    or drop the reference to the shared mesh, or delete them.
+void GlGeomBase::ReleaseBuffers()
+{
+    if (arenaAllocId >= 0) {
+        theArena->Free(arenaAllocId);
+        arenaAllocId = -1;
+    }
+    else if (IsShared()) {
+        GlGeomRegistry::Release(sharedKey);
+        sharedKey.clear();
+    }
+    else if (theVAO != 0) {
+        GlGeomStateCache::DeleteVertexArray(theVAO);
+        glDeleteBuffers(1, &theVBO);
+        glDeleteBuffers(1, &theEBO);
+        if (Budget() != nullptr) {
+            Budget()->RecordRelease(this);
+        }
+    }
+    if (thePositionVAO != 0) {
+        GlGeomStateCache::DeleteVertexArray(thePositionVAO);
+        thePositionVAO = 0;
+    }
+    positionVaoDirty = true;
+    usesDSA = false;
+    theVAO = 0;
+    theVBO = 0;
+    theEBO = 0;
+    vboCapacity = 0;
+    eboCapacity = 0;
+}
+
+void GlGeomBase::SetVertexFormat(const GlGeomVertexFormat& format)
+{
+    if (format == vertexFormat) {
+        return;
+    }
+    vertexFormat = format;
+    if (Budget() != nullptr) {
+        Budget()->DropCpuCopy(this);     // Its vertex layout is out of date
+    }
+    if (theVAO != 0) {
+        ReInitializeAttribLocations();
+    }
+}
+
+void GlGeomBase::SetArena(GlGeomArena* arena)
+{
+    if (arena == theArena) {
+        return;
+    }
+    bool wasInitialized = (theVAO != 0);
+    ReleaseBuffers();
+    theArena = arena;
+    if (wasInitialized) {
+        ReInitializeAttribLocations();
+    }
+}
+
+int GlGeomBase::GetBaseVertex() const
+{
+    return (arenaAllocId >= 0) ? theArena->GetBaseVertex(arenaAllocId) : 0;
+}
+
+int GlGeomBase::GetFirstElement() const
+{
+    return (arenaAllocId >= 0) ? theArena->GetFirstElement(arenaAllocId) : 0;
+}
+
+// Set the vertex attribute pointers to match the vertex layout.
+// The VAO and the VBO must be bound.
+void GlGeomBase::SetVertexAttribPointers()
+{
+    SetVertexAttribPointers(vertexLayout, posLoc, normalLoc, texcoordsLoc);
+}
+
+void GlGeomBase::SetVertexAttribPointers(const GlGeomVertexLayout& layout,
+    unsigned int posLoc, unsigned int normalLoc, unsigned int texcoordsLoc)
+{
+    GLenum posType = (layout.format.posFormat == GlGeomPosFormat::Float32) ? GL_FLOAT : GL_SHORT;
+    GLboolean posNormalized = (posType == GL_FLOAT) ? GL_FALSE : GL_TRUE;
+    glVertexAttribPointer(posLoc, layout.PosComponents(), posType, posNormalized, layout.posStride,
+        (void*)(size_t)layout.posOffset);
     glEnableVertexAttribArray(posLoc);
-    if (UseNormals()) {
-        glVertexAttribPointer(normalLoc, 3, GL_FLOAT, GL_FALSE, StrideVal() * sizeof(float),
-            (void*)(NormalOffset() * sizeof(float)));
+    if (layout.useNormals) {
+        switch (layout.format.normalFormat) {
+        case GlGeomNormalFormat::Float32:
+            glVertexAttribPointer(normalLoc, 3, GL_FLOAT, GL_FALSE, layout.attribStride,
+                (void*)(size_t)(layout.attribStart + layout.normalOffset));
+            break;
+        case GlGeomNormalFormat::OctSNorm16:
+            glVertexAttribPointer(normalLoc, 2, GL_SHORT, GL_TRUE, layout.attribStride,
+                (void*)(size_t)(layout.attribStart + layout.normalOffset));
+            break;
+        case GlGeomNormalFormat::FromPosition:
+            // The normal is read from the first three components of the position
+            glVertexAttribPointer(normalLoc, 3, posType, posNormalized, layout.posStride,
+                (void*)(size_t)layout.posOffset);
+            break;
+        }
         glEnableVertexAttribArray(normalLoc);
     }
-    if (UseTexCoords()) {
-         glVertexAttribPointer(texcoordsLoc, 2, GL_FLOAT, GL_FALSE, StrideVal() * sizeof(float),
-            (void*)(TexOffset() * sizeof(float)));
+    if (layout.useTexCoords) {
+        switch (layout.format.texCoordFormat) {
+        case GlGeomTexCoordFormat::Float32:
+            glVertexAttribPointer(texcoordsLoc, 2, GL_FLOAT, GL_FALSE, layout.attribStride,
+                (void*)(size_t)(layout.attribStart + layout.texOffset));
+            break;
+        case GlGeomTexCoordFormat::Half:
+            glVertexAttribPointer(texcoordsLoc, 2, GL_HALF_FLOAT, GL_FALSE, layout.attribStride,
+                (void*)(size_t)(layout.attribStart + layout.texOffset));
+            break;
+        case GlGeomTexCoordFormat::UNorm16:
+            glVertexAttribPointer(texcoordsLoc, 2, GL_UNSIGNED_SHORT, GL_TRUE, layout.attribStride,
+                (void*)(size_t)(layout.attribStart + layout.texOffset));
+            break;
+        }
         glEnableVertexAttribArray(texcoordsLoc);
     }
+}
 
-    CalcVBOandEBO_Base();
+// The relative offsets of the normals and texture coordinates are from attribStart,
+//    which is the offset of the AttribBinding vertex buffer binding.
+void GlGeomBase::SetVertexArrayFormats(unsigned int vao, unsigned int vbo, const GlGeomVertexLayout& layout,
+    unsigned int posLoc, unsigned int normalLoc, unsigned int texcoordsLoc)
+{
+    GLenum posType = (layout.format.posFormat == GlGeomPosFormat::Float32) ? GL_FLOAT : GL_SHORT;
+    GLboolean posNormalized = (posType == GL_FLOAT) ? GL_FALSE : GL_TRUE;
+    glVertexArrayVertexBuffer(vao, PosBinding, vbo, 0, layout.posStride);
+    SetAttribFormat(vao, posLoc, PosBinding, layout.PosComponents(), posType, posNormalized, layout.posOffset);
+    if (layout.useNormals || layout.useTexCoords) {
+        glVertexArrayVertexBuffer(vao, AttribBinding, vbo, (GLintptr)layout.attribStart, layout.attribStride);
+    }
+    if (layout.useNormals) {
+        switch (layout.format.normalFormat) {
+        case GlGeomNormalFormat::Float32:
+            SetAttribFormat(vao, normalLoc, AttribBinding, 3, GL_FLOAT, GL_FALSE, layout.normalOffset);
+            break;
+        case GlGeomNormalFormat::OctSNorm16:
+            SetAttribFormat(vao, normalLoc, AttribBinding, 2, GL_SHORT, GL_TRUE, layout.normalOffset);
+            break;
+        case GlGeomNormalFormat::FromPosition:
+            // The normal is read from the first three components of the position
+            SetAttribFormat(vao, normalLoc, PosBinding, 3, posType, posNormalized, layout.posOffset);
+            break;
+        }
+    }
+    if (layout.useTexCoords) {
+        switch (layout.format.texCoordFormat) {
+        case GlGeomTexCoordFormat::Float32:
+            SetAttribFormat(vao, texcoordsLoc, AttribBinding, 2, GL_FLOAT, GL_FALSE, layout.texOffset);
+            break;
+        case GlGeomTexCoordFormat::Half:
+            SetAttribFormat(vao, texcoordsLoc, AttribBinding, 2, GL_HALF_FLOAT, GL_FALSE, layout.texOffset);
+            break;
+        case GlGeomTexCoordFormat::UNorm16:
+            SetAttribFormat(vao, texcoordsLoc, AttribBinding, 2, GL_UNSIGNED_SHORT, GL_TRUE, layout.texOffset);
+            break;
+        }
+    }
+}
+
+void GlGeomBase::LoadMesh(const GlGeomMesh& mesh)
+{
+    assert(theVAO != 0 && "InitializeAttribLocations must be called before LoadMesh!");
+    CalcVBOandEBO_Base(&mesh);
+    meshState = MeshLoaded;
 }
 
 // Load the data into the VBO and EBO arrays.
-// This invokes the appropriate CalVBOandEBO method
-void GlGeomBase::CalcVBOandEBO_Base() {
+// This invokes the appropriate CalVBOandEBO method, or copies from the mesh if one is given.
+//    If the persistently mapped staging ring is available (OpenGL 4.4), the data is
+//       calculated into the ring and copied on the GPU into the VBO and EBO.
+//    Otherwise, the VBO and EBO are mapped and the data is calculated into them.
+//    If verticesOnly is true, the EBO is not changed.
+void GlGeomBase::CalcVBOandEBO_Base(const GlGeomMesh* mesh, bool verticesOnly) {
+    int numVertices = UseTexCoords() ? GetNumVerticesTexCoords() : GetNumVerticesNoTexCoords();
+    long long vboBytes = (long long)numVertices * vertexLayout.stride;
+    long long eboBytes = verticesOnly ? 0 : (long long)GetNumEboElements() * sizeof(unsigned int);
+    long long vboOffset = (long long)GetBaseVertex() * vertexLayout.stride;
+    long long eboOffset = (long long)GetFirstElement() * sizeof(unsigned int);
+
+    GlGeomStagingRing* ring = GlGeomStagingRing::Default();
+    long long ringOffset;
+    unsigned char* staging = (ring != nullptr) ? (unsigned char*)ring->Reserve(vboBytes + eboBytes, &ringOffset) : nullptr;
+    if (staging != nullptr) {
+        // vboBytes is a multiple of 4, so the elements are aligned.
+        FillVboAndEbo(staging, verticesOnly ? nullptr : (unsigned int*)(staging + vboBytes), numVertices, mesh);
+        ring->CopyToBuffer(ringOffset, theVBO, vboOffset, vboBytes);
+        ring->CopyToBuffer(ringOffset + vboBytes, theEBO, eboOffset, eboBytes);
+        ring->Fence(ringOffset, vboBytes + eboBytes);
+        return;
+    }
+
+    // With direct state access, the buffers are mapped without binding them.
+    if (usesDSA) {
+        void* VBOdata = glMapNamedBufferRange(theVBO, (GLintptr)vboOffset, (GLsizeiptr)vboBytes,
+            GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT);
+        unsigned int* EBOdata = nullptr;
+        if (!verticesOnly) {
+            EBOdata = (unsigned int*)glMapNamedBufferRange(theEBO, (GLintptr)eboOffset, (GLsizeiptr)eboBytes,
+                GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT);
+        }
+        FillVboAndEbo(VBOdata, EBOdata, numVertices, mesh);
+        glUnmapNamedBuffer(theVBO);
+        if (!verticesOnly) {
+            glUnmapNamedBuffer(theEBO);
+        }
+        return;
+    }
 
 	// Calculate the buffer data - map and the unmap the two buffers.
-    glBindVertexArray(theVAO);
+    //    Only this object's ranges are mapped (all of the VBO and EBO, unless in an arena).
+    GlGeomStateCache::BindVertexArray(theVAO);
     glBindBuffer(GL_ARRAY_BUFFER, theVBO);
     glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, theEBO);
-    float* VBOdata = (float*)glMapBuffer(GL_ARRAY_BUFFER, GL_WRITE_ONLY);
-    unsigned int* EBOdata = (unsigned int*)glMapBuffer(GL_ELEMENT_ARRAY_BUFFER, GL_WRITE_ONLY);
-    int normalOffset = UseNormals() ? NormalOffset() : -1;
-    int tcOffset = UseTexCoords() ? TexOffset() : -1;
-    CalcVboAndEbo(VBOdata, EBOdata, 0, normalOffset, tcOffset, StrideVal());
+    void* VBOdata = glMapBufferRange(GL_ARRAY_BUFFER, (GLintptr)vboOffset, (GLsizeiptr)vboBytes,
+        GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT);
+    unsigned int* EBOdata = nullptr;
+    if (!verticesOnly) {
+        EBOdata = (unsigned int*)glMapBufferRange(GL_ELEMENT_ARRAY_BUFFER, (GLintptr)eboOffset, (GLsizeiptr)eboBytes,
+            GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT);
+    }
+    FillVboAndEbo(VBOdata, EBOdata, numVertices, mesh);
     glUnmapBuffer(GL_ARRAY_BUFFER);
-    glUnmapBuffer(GL_ELEMENT_ARRAY_BUFFER);
+    if (!verticesOnly) {
+        glUnmapBuffer(GL_ELEMENT_ARRAY_BUFFER);
+    }
  
     // Good practice to unbind things: helps with debugging if nothing else
-    glBindVertexArray(0); 
+    GlGeomStateCache::BindVertexArray(0); 
     glBindBuffer(GL_ARRAY_BUFFER, 0);
     glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
 }
 
+void GlGeomBase::SetConstMeshData(const GlGeomConstMeshData& data)
+{
+    constMesh = data;
+    constMeshKey = GetShapeKey();
+    hasConstMesh = true;
+    SetMeshDirty();
+}
+
+void GlGeomBase::SetMeshDirty(bool verticesOnly)
+{
+    meshletsDirty = true;
+    if (Budget() != nullptr) {
+        Budget()->DropCpuCopy(this);
+    }
+    if (!verticesOnly) {
+        meshState = MeshDirty;
+    }
+    else if (meshState == MeshLoaded) {
+        meshState = VerticesDirty;
+    }
+}
+
+// Update the VBO and EBO if the mesh has changed.
+//    A shared mesh is never updated in place: re-initializing switches to the shared mesh for the new key.
+//    An evicted mesh (see GlGeomBudget.h) is loaded again.
+//    The budget is told that the mesh is used in this frame.
 void GlGeomBase::PreRender() {
-    if (theVAO == 0) {
+    assert(!loadPending && "The shape is still being loaded by a GlGeomLoader!");
+    if (theVAO == 0 && !evicted) {
         assert(false && "InitializeAttribLocations must be called before rendering!");
     }
+    // New vertices which need another layout (e.g., no longer in the unit cube, so
+    //    not in SNorm16) cannot be written into the old one.
+    if (meshState == VerticesDirty) {
+        GlGeomVertexLayout layout = CalcVertexLayout();
+        if (!(layout.format == vertexLayout.format) || layout.stride != vertexLayout.stride) {
+            meshState = MeshDirty;
+        }
+    }
+    if (meshState == MeshDirty || (meshState == VerticesDirty && IsShared())) {
+        ReInitializeAttribLocations();
+    }
+    else if (meshState == VerticesDirty) {
+        CalcVBOandEBO_Base(nullptr, true);
+        meshState = MeshLoaded;
+    }
+    if (Budget() != nullptr) {
+        Budget()->MarkUsed(this);
+    }
  }
 
 // **********************************************
@@ -117,35 +668,312 @@ void GlGeomBase::RenderEBO(unsigned int drawMode, int numRenderElements, int EBO
     if (theVAO == 0) {
         assert(false && "InitializeAttribLocations must be called before rendering!");
     }
-    glBindVertexArray(theVAO);
+    GlGeomStateCache::BindVertexArray(theVAO);
+    if (theArena != nullptr) {
+        // The arena's VAO is left bound, since the next shape drawn probably uses it too.
+        glDrawElementsBaseVertex(drawMode, (GLsizei)numRenderElements, GL_UNSIGNED_INT,
+            (void*)((GetFirstElement() + EBOstart) * sizeof(unsigned int)), GetBaseVertex());
+        return;
+    }
     glDrawElements(drawMode, (GLsizei)numRenderElements, GL_UNSIGNED_INT, (void*)(EBOstart * sizeof(unsigned int)));
-    glBindVertexArray(0);           // Good practice to unbind: helps with debugging if nothing else
+    UnbindVAO();
+}
+
+// Good practice to unbind the VAO after rendering: helps with debugging if nothing else.
+//    Not done with direct state access, since then nothing is set up by binding the VAO,
+//    or with the state cache, since then every VAO bind goes through the cache (and
+//    binding the same VAO for the next render is free).
+void GlGeomBase::UnbindVAO() const
+{
+    if (!usesDSA && !GlGeomStateCache::IsEnabled()) {
+        GlGeomStateCache::BindVertexArray(0);
+    }
+}
+
+// **********************************************
+// Render with only the vertex positions, for depth-only, shadow and picking passes.
+//    The position-only VAO has just the position attribute. With split streams
+//    (see GlGeomVertexFormat.h), only the position stream is read.
+//    In an arena, the arena's VAO is used (its vertices are interleaved anyway).
+// **********************************************
+void GlGeomBase::RenderPositionOnly()
+{
+    RenderPositionOnly(0);
+}
+
+void GlGeomBase::RenderPositionOnly(int group)
+{
+    PreRender();
+    int first, num;
+    GetElementGroup(group, &first, &num);
+    if (theArena != nullptr) {
+        RenderEBO(GL_TRIANGLES, num, first);
+        return;
+    }
+    if (positionVaoDirty) {
+        GlGeomVertexLayout positionLayout = vertexLayout;
+        positionLayout.useNormals = false;
+        positionLayout.useTexCoords = false;
+        if (usesDSA) {
+            if (thePositionVAO == 0) {
+                glCreateVertexArrays(1, &thePositionVAO);
+            }
+            glVertexArrayElementBuffer(thePositionVAO, theEBO);
+            SetVertexArrayFormats(thePositionVAO, theVBO, positionLayout, posLoc, UINT_MAX, UINT_MAX);
+        }
+        else {
+            if (thePositionVAO == 0) {
+                glGenVertexArrays(1, &thePositionVAO);
+            }
+            GlGeomStateCache::BindVertexArray(thePositionVAO);
+            glBindBuffer(GL_ARRAY_BUFFER, theVBO);
+            glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, theEBO);
+            SetVertexAttribPointers(positionLayout, posLoc, UINT_MAX, UINT_MAX);
+        }
+        positionVaoDirty = false;
+    }
+    GlGeomStateCache::BindVertexArray(thePositionVAO);
+    glDrawElements(GL_TRIANGLES, (GLsizei)num, GL_UNSIGNED_INT, (void*)(first * sizeof(unsigned int)));
+    UnbindVAO();
+}
+
+// **********************************************
+// Instanced rendering: count copies with one draw call.
+//    The instance attributes are set in the VAO for the draw only, since
+//    the VAO may be shared (GlGeomRegistry.h, GlGeomArena.h) and the
+//    instance buffer may be different each time.
+// **********************************************
+void GlGeomBase::RenderInstanced(int count, unsigned int instanceBuffer, int firstInstance)
+{
+    PreRender();
+    RenderEBOInstanced(GL_TRIANGLES, GetNumElements(), 0, count, instanceBuffer, firstInstance);
+}
+
+void GlGeomBase::SetInstanceAttribLocations(unsigned int matrix_loc, unsigned int color_loc, unsigned int scale_loc)
+{
+    instanceMatrixLoc = matrix_loc;
+    instanceColorLoc = color_loc;
+    instanceScaleLoc = scale_loc;
+}
+
+void GlGeomBase::RenderEBOInstanced(unsigned int drawMode, int numRenderElements, int EBOstart,
+    int count, unsigned int instanceBuffer, int firstInstance)
+{
+    if (theVAO == 0) {
+        assert(false && "InitializeAttribLocations must be called before rendering!");
+    }
+    if (count <= 0) {
+        return;
+    }
+    GlGeomStateCache::BindVertexArray(theVAO);
+    GlGeomInstanceBuffer::SetAttribPointers(instanceBuffer, firstInstance,
+        instanceMatrixLoc, instanceColorLoc, instanceScaleLoc);
+    void* offset = (void*)((GetFirstElement() + EBOstart) * sizeof(unsigned int));
+    if (theArena != nullptr) {
+        glDrawElementsInstancedBaseVertex(drawMode, (GLsizei)numRenderElements, GL_UNSIGNED_INT,
+            offset, (GLsizei)count, GetBaseVertex());
+    }
+    else {
+        glDrawElementsInstanced(drawMode, (GLsizei)numRenderElements, GL_UNSIGNED_INT, offset, (GLsizei)count);
+    }
+    GlGeomInstanceBuffer::DisableAttribs(instanceMatrixLoc, instanceColorLoc, instanceScaleLoc);
+    if (theArena == nullptr) {
+        UnbindVAO();
+    }
 }
 
 // **********************************************
-// This routine does the rendering of the specified elements
-//    A temporary EBO is created for this purpose
-//    (For this reason it is not really efficient for repeated use.)
+// Render several ranges of the EBO data, with one draw call.
+//    Range i is counts[i] elements, starting at element EBOstarts[i].
 // **********************************************
-void GlGeomBase::RenderElements(unsigned int drawMode, int numRenderElements, const unsigned int *elementsData)
+void GlGeomBase::RenderEBORanges(unsigned int drawMode, int numRanges, const int* counts, const int* EBOstarts)
 {
-    unsigned int tempEBO;
-    glGenBuffers(1, &tempEBO);
-    glBindVertexArray(theVAO);
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, tempEBO);
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER, numRenderElements * sizeof(unsigned int), elementsData, GL_STATIC_DRAW);
+    if (theVAO == 0) {
+        assert(false && "InitializeAttribLocations must be called before rendering!");
+    }
+    if (numRanges == 0) {
+        return;
+    }
+    rangeOffsets.resize(numRanges);
+    int firstElement = GetFirstElement();
+    for (int i = 0; i < numRanges; i++) {
+        rangeOffsets[i] = (const void*)((firstElement + EBOstarts[i]) * sizeof(unsigned int));
+    }
+    GlGeomStateCache::BindVertexArray(theVAO);
+    if (theArena != nullptr) {
+        rangeBaseVertices.assign(numRanges, GetBaseVertex());
+        glMultiDrawElementsBaseVertex(drawMode, counts, GL_UNSIGNED_INT,
+            rangeOffsets.data(), numRanges, rangeBaseVertices.data());
+        return;
+    }
+    glMultiDrawElements(drawMode, counts, GL_UNSIGNED_INT, rangeOffsets.data(), numRanges);
+    UnbindVAO();
+}
 
-    glDrawElements(drawMode, numRenderElements, GL_UNSIGNED_INT, 0);
-    
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, theEBO);  // Restore the main EBO (The VAO maintains its knowledge of this)
-    glDeleteBuffers(1, &tempEBO);
-    glBindVertexArray(0);
+void GlGeomBase::SetUseMeshlets(bool use)
+{
+    useMeshlets = use;
+}
 
+// Make the meshlets from the mesh, calculated again in memory.
+void GlGeomBase::BuildMeshlets()
+{
+    GlGeomMesh mesh;
+    GenerateMesh(mesh, false, UseTexCoords());
+    int numGroups = GetNumElementGroups();
+    std::vector<int> groupFirst(numGroups);
+    std::vector<int> groupNum(numGroups);
+    for (int i = 0; i < numGroups; i++) {
+        GetElementGroup(i, &groupFirst[i], &groupNum[i]);
+    }
+    if (meshlets == nullptr) {
+        meshlets = new GlGeomMeshlets();
+    }
+    meshlets->Build(mesh, numGroups, groupFirst.data(), groupNum.data());
+    meshlets->Upload();
+    meshletsDirty = false;
+}
+
+int GlGeomBase::RenderCulled(const LinearMapR4& modelview, const LinearMapR4& projection)
+{
+    return RenderCulled(modelview, projection, 0);
+}
+
+// **********************************************
+// Render one group of GL_TRIANGLES elements, skipping the culled meshlets.
+//    The meshlets' EBO is bound to the VAO for the draw, and the main EBO
+//    is bound again afterwards.
+// **********************************************
+int GlGeomBase::RenderCulled(const LinearMapR4& modelview, const LinearMapR4& projection, int group)
+{
+    PreRender();
+    if (!useMeshlets || !CanCullMeshlets()) {
+        int first, num;
+        GetElementGroup(group, &first, &num);
+        RenderEBO(GL_TRIANGLES, num, first);
+        return num / 3;
+    }
+    if (meshletsDirty) {
+        BuildMeshlets();
+    }
+    int numDraws = meshlets->Cull(modelview, projection, group, GetBaseVertex());
+    if (numDraws == 0) {
+        return 0;
+    }
+    GlGeomStateCache::BindVertexArray(theVAO);
+    if (usesDSA) {
+        glVertexArrayElementBuffer(theVAO, meshlets->GetEBO());
+    }
+    else {
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, meshlets->GetEBO());
+    }
+    if (theArena != nullptr) {
+        glMultiDrawElementsBaseVertex(GL_TRIANGLES, meshlets->GetDrawCounts(), GL_UNSIGNED_INT,
+            meshlets->GetDrawOffsets(), numDraws, meshlets->GetDrawBaseVertices());
+    }
+    else {
+        glMultiDrawElements(GL_TRIANGLES, meshlets->GetDrawCounts(), GL_UNSIGNED_INT,
+            meshlets->GetDrawOffsets(), numDraws);
+    }
+    // Restore the main EBO (The VAO maintains its knowledge of this)
+    if (usesDSA) {
+        glVertexArrayElementBuffer(theVAO, theEBO);
+    }
+    else {
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, theEBO);
+    }
+    if (theArena == nullptr) {
+        UnbindVAO();
+    }
+    return meshlets->GetNumTrianglesVisible();
 }
 
 GlGeomBase::~GlGeomBase()
 {
-    glDeleteBuffers(3, &theVAO);  // The three buffer id's are contigous in memory!
+    assert(!loadPending && "The shape is still being loaded by a GlGeomLoader!");
+    assert(!remeshPending && "The shape is still being re-meshed by a GlGeomLoader!");
+    ReleaseBuffers();
+    if (Budget() != nullptr) {
+        Budget()->Forget(this);
+    }
+    delete meshlets;
+}
+
+GlGeomBase::GlGeomBase(GlGeomBase&& other) noexcept
+{
+    MoveFrom(other);
+}
+
+GlGeomBase& GlGeomBase::operator=(GlGeomBase&& other) noexcept
+{
+    if (this != &other) {
+        assert(!loadPending && "The shape is still being loaded by a GlGeomLoader!");
+        ReleaseBuffers();
+        if (Budget() != nullptr) {
+            Budget()->Forget(this);
+        }
+        delete meshlets;
+        MoveFrom(other);
+    }
+    return *this;
+}
+
+// Take over the other object's buffers and meshlets, and copy its settings.
+//    The other object is left with no buffers, as after ReleaseBuffers(), and
+//    will calculate its mesh again if it is initialized again.
+void GlGeomBase::MoveFrom(GlGeomBase& other)
+{
+    assert(!other.loadPending && "The shape is still being loaded by a GlGeomLoader!");
+    assert(!other.remeshPending && "The shape is still being re-meshed by a GlGeomLoader!");
+    theVAO = other.theVAO;
+    theVBO = other.theVBO;
+    theEBO = other.theEBO;
+    thePositionVAO = other.thePositionVAO;
+    positionVaoDirty = other.positionVaoDirty;
+    posLoc = other.posLoc;
+    normalLoc = other.normalLoc;
+    texcoordsLoc = other.texcoordsLoc;
+    instanceMatrixLoc = other.instanceMatrixLoc;
+    instanceColorLoc = other.instanceColorLoc;
+    instanceScaleLoc = other.instanceScaleLoc;
+    vertexFormat = other.vertexFormat;
+    vertexLayout = other.vertexLayout;
+    vboCapacity = other.vboCapacity;
+    eboCapacity = other.eboCapacity;
+    usesDSA = other.usesDSA;
+    meshState = other.meshState;
+    sharedKey = std::move(other.sharedKey);
+    theArena = other.theArena;
+    arenaAllocId = other.arenaAllocId;
+    useMeshlets = other.useMeshlets;
+    meshletsDirty = other.meshletsDirty;
+    meshlets = other.meshlets;
+    hasConstMesh = other.hasConstMesh;
+    constMesh = other.constMesh;
+    constMeshKey = other.constMeshKey;
+    loadPending = false;
+    evictable = other.evictable;
+    evicted = other.evicted;
+    inBudget = other.inBudget;
+    if (Budget() != nullptr) {
+        Budget()->MoveOwner(&other, this);
+    }
+    other.inBudget = false;
+
+    other.theVAO = 0;
+    other.theVBO = 0;
+    other.theEBO = 0;
+    other.thePositionVAO = 0;
+    other.positionVaoDirty = true;
+    other.vboCapacity = 0;
+    other.eboCapacity = 0;
+    other.usesDSA = false;
+    other.meshState = MeshDirty;
+    other.sharedKey.clear();
+    other.arenaAllocId = -1;
+    other.meshletsDirty = true;
+    other.meshlets = nullptr;
+    other.evicted = false;
 }
 
 
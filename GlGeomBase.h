@@ -27,11 +27,25 @@
 #define GLGEOM_BASE_H
 
 #include <limits>
+#include <limits.h>
+#include <string>
+#include <vector>
+#include "GlGeomVertexFormat.h"
+#include "GlGeomConstMesh.h"
+#include "GlGeomInstances.h"
+
+class GlGeomArena;
+class GlGeomBudget;
+class GlGeomMesh;
+class GlGeomMeshlets;
+class LinearMapR4;
 
 // GlGeomBase
 //     Handles all the OpenGL rendering for the GlGeomShape classes.
 // Supports the following:
 //    (1) Allocating a VAO, VBO, and EBO
+//          (optionally shared with other objects with the same mesh, see GlGeomRegistry.h)
+//          (or ranges in the large shared buffers of a GlGeomArena, see GlGeomArena.h)
 //    (2) Doing the rendering with OpenGL
 
 class GlGeomBase
@@ -40,13 +54,17 @@ public:
     GlGeomBase() {}
     ~GlGeomBase();
 
-    // Disable all copy and assignment operators for a GlGeomBase object.
+    // Disable copying of a GlGeomBase object, since it owns its VAO, VBO and EBO.
     //     If you need to pass it to/from a function, use references or pointers
     //     and be sure that there are no implicit copy or assignment operations!
     GlGeomBase(const GlGeomBase&) = delete;
     GlGeomBase& operator=(const GlGeomBase&) = delete;
-    GlGeomBase(GlGeomBase&&) = delete;
-    GlGeomBase& operator=(GlGeomBase&&) = delete;
+    // Moving hands over the VAO, VBO and EBO (or the shared mesh, or the ranges in
+    //     an arena), so shapes can be kept in a std::vector.  The moved-from object keeps
+    //     its settings but has no buffers, and must be initialized again before rendering.
+    //     A shape being loaded by a GlGeomLoader cannot be moved.
+    GlGeomBase(GlGeomBase&& other) noexcept;
+    GlGeomBase& operator=(GlGeomBase&& other) noexcept;
 
     // These must be implemented in each GlGeomShape class.
     //   GetNumElements() returns the number of elements in the EBO for rendering
@@ -56,15 +74,147 @@ public:
     virtual int GetNumVerticesTexCoords() const = 0;
     virtual int GetNumVerticesNoTexCoords() const = 0;
 
+    // Shapes may store extra index ranges in the EBO after the GetNumElements() elements
+    //    for GL_TRIANGLES, for rendering parts of the shape (e.g. as triangle strips).
+    //    They are calculated once per mesh, by CalcSubRangeElements().
+    //   GetNumSubRangeElements() returns the number of these extra elements.
+    //   GetNumEboElements() returns the total number of elements in the EBO.
+    virtual int GetNumSubRangeElements() const { return 0; }
+    int GetNumEboElements() const { return GetNumElements() + GetNumSubRangeElements(); }
+
+    // GenerateMesh(): Calculate the mesh into a GlGeomMesh in CPU memory.
+    //    Does not use OpenGL, and can be called without an OpenGL context
+    //    and before InitializeAttribLocations().
+    void GenerateMesh(GlGeomMesh& mesh, bool calcNormals, bool calcTexCoords);
+    // LoadMesh(): Load a mesh from GenerateMesh() into the VBO and EBO, instead of calculating it.
+    //    InitializeAttribLocations() must have been called. The mesh must be for the
+    //    current mesh resolution and have the normals and texture coordinates in use.
+    void LoadMesh(const GlGeomMesh& mesh);
+
     unsigned int GetVAO() const { return theVAO; }
     unsigned int GetVBO() const { return theVBO; }
     unsigned int GetEBO() const { return theEBO; }
 
+    // Select the storage formats for the vertex data in the VBO.
+    // See GlGeomVertexFormat.h. The default is all floats.
+    // Best called before InitializeAttribLocations(). If called afterwards,
+    //    the VBO is rebuilt and the vertex attribute pointers are reset.
+    // If quantized normals (OctSNorm16) are used, the shader must decode them.
+    void SetVertexFormat(const GlGeomVertexFormat& format);
+    const GlGeomVertexFormat& GetVertexFormat() const { return vertexFormat; }
+    // The byte layout actually in use in the VBO (valid after InitializeAttribLocations).
+    const GlGeomVertexLayout& GetVertexLayout() const { return vertexLayout; }
+
+    // Shapes override these to allow the more compact vertex formats.
+    //   NormalsEqualPositions() - true if every normal equals its position (unit sphere)
+    //   FitsUnitCube() - true if every vertex position lies in [-1,1]^3.
+    virtual bool NormalsEqualPositions() const { return false; }
+    virtual bool FitsUnitCube() const { return false; }
+
+    // Keys identifying the mesh, for sharing VAO/VBO/EBO's (see GlGeomRegistry.h)
+    //   GetShapeKey() - the shape type and parameters, e.g. "GlGeomSphere 6 6".
+    //        Shapes return an empty string (the default) if they are never shared.
+    //   GetMeshKey() - the shape key, plus the attribute locations and vertex format.
+    virtual std::string GetShapeKey() const { return std::string(); }
+    std::string GetMeshKey() const;
+    bool IsShared() const { return !sharedKey.empty(); }
+
+    // Place the vertex and element data in ranges of a GlGeomArena,
+    //    instead of in a VBO and EBO owned by this object.
+    //    Best called before InitializeAttribLocations().  Use nullptr to leave the arena.
+    void SetArena(GlGeomArena* arena);
+    GlGeomArena* GetArena() const { return theArena; }
+    // Offsets of this object's data in the VBO and EBO (non-zero only in an arena).
+    int GetBaseVertex() const;
+    int GetFirstElement() const;
+
+    // Meshlets: split the triangles into small clusters, which are culled on the CPU
+    //    by RenderCulled() if they are outside the view frustum or face away from
+    //    the viewer (see GlGeomMeshlets.h). Only useful if back faces are culled.
+    //    The meshlets are made when first needed, and again after the mesh changes.
+    void SetUseMeshlets(bool use);
+    bool UsesMeshlets() const { return useMeshlets; }
+    const GlGeomMeshlets* GetMeshlets() const { return meshlets; }
+    // Shapes whose vertex positions are finished in the vertex shader override this
+    //    to return false, since their meshlet bounds would be wrong.  RenderCulled()
+    //    then renders every triangle.
+    virtual bool CanCullMeshlets() const { return true; }
+
+    // RenderPositionOnly(): Render the GL_TRIANGLES elements (like Render()) with a VAO
+    //    that has only the position attribute, for depth-only, shadow and picking passes.
+    //    Use the vertex format's splitStreams (GlGeomVertexFormat.h) so that only the
+    //    positions are read from the VBO.
+    void RenderPositionOnly();
+    unsigned int GetPositionVAO() const { return thePositionVAO; }
+
+    // RenderInstanced(): Render count copies of the GL_TRIANGLES elements with one draw call.
+    //    instanceBuffer holds the per-instance data (see GlGeomInstances.h), starting
+    //    at instance firstInstance.  The shader must read the instance attributes.
+    //    The instance attributes are disabled in the VAO again after the draw,
+    //    so the VAO can still be used with shaders that do not have them.
+    void RenderInstanced(int count, unsigned int instanceBuffer, int firstInstance = 0);
+    // The shader locations of the instance attributes (default: see GlGeomInstance).
+    //    Use UINT_MAX for attributes the shader does not have.
+    void SetInstanceAttribLocations(unsigned int matrix_loc, unsigned int color_loc, unsigned int scale_loc);
+
+    // RenderCulled(): Render the GL_TRIANGLES elements (like Render()),
+    //    skipping culled meshlets if meshlets are used.
+    //    modelview and projection are the matrices loaded into the shader.
+    //    Returns the number of triangles rendered.
+    int RenderCulled(const LinearMapR4& modelview, const LinearMapR4& projection);
+
+    // Shapes whose GL_TRIANGLES elements are rendered in separate groups (e.g. levels
+    //    of detail) override these, so that meshlets do not mix triangles from different groups.
+    virtual int GetNumElementGroups() const { return 1; }
+    virtual void GetElementGroup(int /*group*/, int* firstElement, int* numElements) const {
+        *firstElement = 0;
+        *numElements = GetNumElements();
+    }
+
+    // Set the vertex attribute pointers for a vertex layout.
+    // The VAO and the VBO must be bound.
+    static void SetVertexAttribPointers(const GlGeomVertexLayout& layout,
+        unsigned int pos_loc, unsigned int normal_loc, unsigned int texcoords_loc);
+    // The same, with direct state access: nothing needs to be bound.
+    //    The positions are read through vertex buffer binding PosBinding, and the
+    //    normals and texture coordinates through binding AttribBinding.
+    static const unsigned int PosBinding = 0;
+    static const unsigned int AttribBinding = 1;
+    static void SetVertexArrayFormats(unsigned int vao, unsigned int vbo, const GlGeomVertexLayout& layout,
+        unsigned int pos_loc, unsigned int normal_loc, unsigned int texcoords_loc);
+
+    // Direct state access (OpenGL 4.5 or ARB_direct_state_access).  When available, the
+    //    VAO, VBO and EBO are created (with glCreateBuffers and glNamedBufferStorage),
+    //    set up and re-meshed without binding them, so no binding state is changed,
+    //    and renders do not unbind the VAO afterwards.
+    //    Shapes keep the choice made when their buffers were created.
+    //    It can be disabled, e.g. for testing the other code path.
+    static bool IsDSASupported();
+    static void SetDSAEnabled(bool enabled);
+    static bool UseDSA();
+    bool UsesDSA() const { return usesDSA; }
+
+    // Eviction (see GlGeomBudget.h): an evictable shape's VAO, VBO and EBO may be
+    //    released by the budget when it has not been rendered recently, and its
+    //    mesh is loaded again when it is next rendered. Only for shapes which
+    //    own their buffers (not shared, not in an arena).
+    void SetEvictable(bool evictable);
+    bool IsEvictable() const { return evictable; }
+    bool IsEvicted() const { return evicted; }
+
+    // Background loading (see GlGeomLoader.h): IsLoading() is true from GlGeomLoader::Load()
+    //    until the render thread takes over the new VBO and EBO in GlGeomLoader::Poll().
+    //    While loading, the shape has no VAO, and must not be rendered, re-meshed or deleted.
+    // IsRemeshing() is true from GlGeomLoader::Remesh() until the shape takes over its new mesh.
+    //    The old mesh is rendered until then.  The shape must not be deleted or moved while re-meshing.
+    bool IsLoading() const { return loadPending; }
+    bool IsRemeshing() const { return remeshPending; }
+
 protected:
     // The routine CalcVboAndEbo must be implemented for all GlGeomShape classes, 
     //    but is meant for internal use, and is not usually called by the user.
     // It is called from the constructor or a ReMesh() or Render() method
-    //         via a call to InitializeAttribLocations. It takes as input:
+    //         via a call to InitializeAttribLocations, and from GenerateMesh(). It takes as input:
     //    * Pointers to the VBO buffer and EBO buffer. Typically these
     //      are allocated earlier by InitializeAttribLocations
     //    * Layout of data in the VBO:  offsets for the vertex position,
@@ -82,6 +232,7 @@ protected:
     //   For the (unit) sphere, the normals are always exactly equal to the positions.
     // Output: 
     //   Data VBO and EBO data is calculated and loaded into the two buffers VBOdataBuffer and EBOdataBuffer.
+    //   If EBOdataBuffer is null, only the vertex data is calculated (the elements have not changed).
     // Typical usages are:
     //   CalcVboAndEbo( vboPtr, eboPtr, 0, -1, -1, 3); // positions only, tightly packed
     //   CalcVboAndEbo( vboPtr, eboPtr, 0, -1, 3, 5); // positions, then (s,t) texture coords, tightly packed
@@ -90,6 +241,11 @@ protected:
             int vertPosOffset, int vertNormalOffset, int vertTexCoordsOffset,
             unsigned int stride) = 0;
 
+    // CalcSubRangeElements() fills in the GetNumSubRangeElements() extra elements.
+    //   EBOdataBuffer points to where they go, just after the GL_TRIANGLES elements.
+    //   calcTexCoords is true if the vertices are numbered for texture coordinates.
+    virtual void CalcSubRangeElements(unsigned int* /*EBOdataBuffer*/, bool /*calcTexCoords*/) {}
+
     // Allocate the VAO, VBO, and EBO.
     // Set up info about the Vertex Attribute Locations
     // This must be called before render is first called.
@@ -100,25 +256,102 @@ protected:
     virtual void InitializeAttribLocations(
         unsigned int pos_loc, unsigned int normal_loc = UINT_MAX, unsigned int texcoords_loc = UINT_MAX);
     void ReInitializeAttribLocations();
-    void CalcVBOandEBO_Base();
+    void CalcVBOandEBO_Base(const GlGeomMesh* mesh = nullptr, bool verticesOnly = false);
+    void FillVboAndEbo(void* VBOdata, unsigned int* EBOdata, int numVertices, const GlGeomMesh* mesh,
+        bool useCaches = true);
+    void CalcVboAndEboInLayout(void* VBOdata, unsigned int* EBOdata, int numVertices);
+    void SetVertexAttribPointers();
+    void ReleaseBuffers();
+    void MoveFrom(GlGeomBase& other);
 
+    // Shapes call SetMeshDirty() when their mesh changes, e.g. in Remesh().
+    //    The VBO and EBO are updated by the next PreRender(). The buffers
+    //    are reused when large enough (they only ever grow).
+    //    verticesOnly - true if the number of vertices and the elements are unchanged,
+    //        so that only the vertex data needs to be rewritten.  (If the new vertices
+    //        need a different vertex layout, e.g. FitsUnitCube() changed, the mesh is
+    //        fully re-initialized instead.)
+    void SetMeshDirty(bool verticesOnly = false);
+
+    // Shapes call SetConstMeshData() to use mesh data generated at compile time
+    //    (see GlGeomConstMesh.h) instead of calling CalcVboAndEbo().
+    //    The data is used as long as the shape key does not change, and the
+    //    attributes used are in the data.
+    void SetConstMeshData(const GlGeomConstMeshData& data);
     void PreRender();
     void Render(); 
-    void RenderElements(unsigned int drawMode, int numRenderElements, const unsigned int *elementsData);
     void RenderEBO(unsigned int drawMode, int numRenderElements, int EBOstart);
+    // Render several ranges of the EBO with a single glMultiDrawElements.
+    void RenderEBORanges(unsigned int drawMode, int numRanges, const int* counts, const int* EBOstarts);
+    int RenderCulled(const LinearMapR4& modelview, const LinearMapR4& projection, int group);
+    void RenderPositionOnly(int group);
+    void RenderEBOInstanced(unsigned int drawMode, int numRenderElements, int EBOstart,
+        int count, unsigned int instanceBuffer, int firstInstance);
 
 private:
+    friend class GlGeomDrawBuilder;     // Uses PreRender()
+    friend class GlGeomLoader;          // Uses the routines below, and FillVboAndEbo() on its own thread
+    friend class GlGeomBudget;          // Uses EvictBuffers()
+
+    bool loadPending = false;       // Being loaded by a GlGeomLoader
+    bool remeshPending = false;     // Being re-meshed by a GlGeomLoader (into another object)
+    bool inBudget = false;          // Has recorded buffers with the GlGeomBudget
+    GlGeomBudget* Budget() const;
+    bool evictable = false;
+    bool evicted = false;           // Released by the budget, and loaded again by PreRender()
+    void EvictBuffers(std::vector<unsigned char>* vboCopy, std::vector<unsigned int>* eboCopy);
+    void RecordBuffers();
+    void BeginAsyncLoad(unsigned int pos_loc, unsigned int normal_loc, unsigned int texcoords_loc);
+    void FinishAsyncLoad(unsigned int vbo, unsigned int ebo, long long vboBytes, long long eboBytes);
+    void AdoptBuffers(GlGeomBase& loaded);
+
     unsigned int theVAO = 0;        // Vertex Array Object
     unsigned int theVBO = 0;        // Vertex Buffer Object
     unsigned int theEBO = 0;        // Element Buffer Object;
+    unsigned int thePositionVAO = 0;    // VAO with only the positions (made when first used)
+    bool positionVaoDirty = true;
 
     unsigned int posLoc;            // location of vertex position x,y,z data in the shader program
     unsigned int normalLoc;         // location of vertex normal data in the shader program
     unsigned int texcoordsLoc;      // location of s,t texture coordinates in the shader program.
+    unsigned int instanceMatrixLoc = GlGeomInstance::MatrixLoc;     // Locations of the instance attributes
+    unsigned int instanceColorLoc = GlGeomInstance::ColorLoc;
+    unsigned int instanceScaleLoc = GlGeomInstance::ScaleLoc;
+
+    GlGeomVertexFormat vertexFormat;    // Requested storage formats
+    GlGeomVertexLayout vertexLayout;    // Byte layout in the VBO
+
+    long long vboCapacity = 0;      // Allocated sizes of the (owned) VBO and EBO in bytes
+    long long eboCapacity = 0;
+    bool usesDSA = false;           // The VAO, VBO and EBO were created with direct state access
+    void CreateBuffersDSA(long long vboBytes, long long eboBytes);
+    GlGeomVertexLayout CalcVertexLayout() const;
+    void UnbindVAO() const;
+    enum MeshState { MeshLoaded, VerticesDirty, MeshDirty };
+    MeshState meshState = MeshDirty;
+
+    std::string sharedKey;          // Mesh key if the VAO/VBO/EBO are shared via GlGeomRegistry
+
+    GlGeomArena* theArena = nullptr;    // The arena holding the data, or nullptr
+    int arenaAllocId = -1;              // Allocation id in the arena
+
+    bool useMeshlets = false;
+    bool meshletsDirty = true;          // The meshlets need to be made again
+    GlGeomMeshlets* meshlets = nullptr;
+    void BuildMeshlets();
+
+    bool hasConstMesh = false;
+    GlGeomConstMeshData constMesh = {};
+    std::string constMeshKey;           // The shape key of the compile time mesh
+    bool UseConstMesh(int numVertices) const;
+
+    std::vector<const void*> rangeOffsets;      // Used by RenderEBORanges()
+    std::vector<int> rangeBaseVertices;
 
 public:
-    // Stride value, and offset values for the data in the VBO
+    // Stride value, and offset values for the data returned by CalcVboAndEbo (in floats).
     // These take into account whether normals and texture coordinates are used.
+    // With the default (all float) vertex format, this is also the layout of the VBO.
     bool UseNormals() const { return normalLoc != UINT_MAX; }
     bool UseTexCoords() const { return texcoordsLoc != UINT_MAX; }
     int StrideVal() const {
@@ -0,0 +1,134 @@
+/*
+* GlGeomBaseMesh.cpp - Version 0.9 - October 18, 2026
+*
+* The parts of GlGeomBase which calculate meshes into memory.  This file
+*    does not use OpenGL, so meshes can be generated (GenerateMesh()) in
+*    programs and tests with no OpenGL context.  See GlGeomMesh.h.
+*
+* An addition to the software accompanying POSSIBLE SECOND EDITION TO the book
+*		3D Computer Graphics: A Mathematical Introduction with OpenGL,
+*		by S. Buss, Cambridge University Press, 2003.
+*   Not part of the book's software, and not written by its author.
+*
+* Software is "as-is" and carries no warranty.  It may be used without
+*   restriction, but if you modify it, please change the filenames to
+*   prevent confusion between different versions.
+* Web page of the book's software: http://math.ucsd.edu/~sbuss/MathCG2
+*/
+
+#include "GlGeomBase.h"
+#include "GlGeomBudget.h"
+#include "GlGeomMesh.h"
+#include "GlGeomMeshCache.h"
+#include "assert.h"
+#include <string.h>
+#include <string>
+#include <vector>
+
+void GlGeomBase::GenerateMesh(GlGeomMesh& mesh, bool calcNormals, bool calcTexCoords)
+{
+    mesh.SetLayout(calcNormals, calcTexCoords);
+    mesh.Resize(calcTexCoords ? GetNumVerticesTexCoords() : GetNumVerticesNoTexCoords(), GetNumEboElements());
+    CalcVboAndEbo(mesh.vertices.data(), mesh.elements.data(),
+        mesh.vertPosOffset, mesh.vertNormalOffset, mesh.vertTexCoordsOffset, mesh.stride);
+    CalcSubRangeElements(mesh.elements.data() + GetNumElements(), calcTexCoords);
+}
+
+// Calculate the vertex data (in the VBO layout) and the elements into memory.
+//    If mesh is not null, the data is converted from the mesh instead.
+//    If there is a mesh cache (see GlGeomMeshCache.h), the data is copied from it when possible.
+//    If EBOdata is null, only the vertex data is filled in.
+//    Only reads the shape's state, so it may be called from a GlGeomLoader's thread
+//    (with useCaches false, since the mesh cache and the budget are not thread safe).
+void GlGeomBase::FillVboAndEbo(void* VBOdata, unsigned int* EBOdata, int numVertices, const GlGeomMesh* mesh,
+    bool useCaches)
+{
+    if (mesh != nullptr) {
+        assert(mesh->GetNumVertices() == numVertices && mesh->GetNumElements() == GetNumEboElements());
+        vertexLayout.PackVertices(mesh->vertices.data(), numVertices, mesh->vertPosOffset,
+            mesh->vertNormalOffset, mesh->vertTexCoordsOffset, mesh->stride, VBOdata);
+        if (EBOdata != nullptr) {
+            memcpy(EBOdata, mesh->elements.data(), mesh->elements.size() * sizeof(unsigned int));
+        }
+        return;
+    }
+
+    // A mesh evicted by the budget may have been kept in CPU memory.
+    GlGeomBudget* budget = useCaches ? Budget() : nullptr;
+    if (budget != nullptr && EBOdata != nullptr
+        && budget->TakeCpuCopy(this, VBOdata, EBOdata, (long long)numVertices * vertexLayout.stride,
+            (long long)GetNumEboElements() * sizeof(unsigned int))) {
+        return;
+    }
+
+    // Compile time mesh data is copied as is.
+    if (UseConstMesh(numVertices)) {
+        if (vertexLayout.IsAllFloat() && constMesh.stride == StrideVal()) {
+            memcpy(VBOdata, constMesh.vertices, (size_t)numVertices * constMesh.stride * sizeof(float));
+        }
+        else {
+            vertexLayout.PackVertices(constMesh.vertices, numVertices, 0, constMesh.normalOffset,
+                constMesh.texCoordsOffset, constMesh.stride, VBOdata);
+        }
+        if (EBOdata != nullptr) {
+            memcpy(EBOdata, constMesh.elements, constMesh.numElements * sizeof(unsigned int));
+            CalcSubRangeElements(EBOdata + GetNumElements(), UseTexCoords());
+        }
+        return;
+    }
+
+    // With a mesh cache: copy the cached data, or calculate it and add it to the cache.
+    //    (Not when only the vertices are updated, since the mesh key has not changed,
+    //    and not from a loader thread, since the cache is not thread safe.)
+    GlGeomMeshCache* cache = useCaches ? GlGeomMeshCache::Default() : nullptr;
+    std::string meshKey = (cache != nullptr && EBOdata != nullptr) ? GetMeshKey() : std::string();
+    if (!meshKey.empty()) {
+        long long vboBytes = (long long)numVertices * vertexLayout.stride;
+        long long eboBytes = (long long)GetNumEboElements() * sizeof(unsigned int);
+        const void* cachedVbo;
+        const unsigned int* cachedEbo;
+        if (cache->Find(meshKey, vboBytes, eboBytes, &cachedVbo, &cachedEbo)) {
+            memcpy(VBOdata, cachedVbo, (size_t)vboBytes);
+            memcpy(EBOdata, cachedEbo, (size_t)eboBytes);
+        }
+        else {
+            // Calculated in memory first: the mapped buffers should not be read from.
+            std::vector<unsigned char> vboTemp((size_t)vboBytes);
+            std::vector<unsigned int> eboTemp(GetNumEboElements());
+            CalcVboAndEboInLayout(vboTemp.data(), eboTemp.data(), numVertices);
+            cache->Add(meshKey, vboTemp.data(), vboBytes, eboTemp.data(), eboBytes);
+            memcpy(VBOdata, vboTemp.data(), (size_t)vboBytes);
+            memcpy(EBOdata, eboTemp.data(), (size_t)eboBytes);
+        }
+        return;
+    }
+    CalcVboAndEboInLayout(VBOdata, EBOdata, numVertices);
+}
+
+// Calculate the vertex data and elements with CalcVboAndEbo, converting to the VBO layout.
+void GlGeomBase::CalcVboAndEboInLayout(void* VBOdata, unsigned int* EBOdata, int numVertices)
+{
+    int normalOffset = UseNormals() ? NormalOffset() : -1;
+    int tcOffset = UseTexCoords() ? TexOffset() : -1;
+    if (vertexLayout.IsAllFloat()) {
+        CalcVboAndEbo((float*)VBOdata, EBOdata, 0, normalOffset, tcOffset, StrideVal());
+    }
+    else {
+        // Calculate as floats, then convert to the quantized formats.
+        std::vector<float> floatData(numVertices * StrideVal());
+        CalcVboAndEbo(floatData.data(), EBOdata, 0, normalOffset, tcOffset, StrideVal());
+        vertexLayout.PackVertices(floatData.data(), numVertices, 0, normalOffset, tcOffset, StrideVal(), VBOdata);
+    }
+    if (EBOdata != nullptr) {
+        CalcSubRangeElements(EBOdata + GetNumElements(), UseTexCoords());
+    }
+}
+
+bool GlGeomBase::UseConstMesh(int numVertices) const
+{
+    return hasConstMesh
+        && constMesh.numVertices == numVertices && constMesh.numElements == GetNumElements()
+        && (constMesh.texCoordsOffset >= 0) == UseTexCoords()
+        && (constMesh.normalOffset >= 0 || !UseNormals())
+        && GetShapeKey() == constMeshKey;
+}
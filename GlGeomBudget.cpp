@@ -0,0 +1,195 @@
+/*
+* GlGeomBudget.cpp - Version 0.9 - October 18, 2026
+*
+* Tracks the buffer memory of the GlGeomShape classes, and evicts
+*    least recently used meshes when over budget.
+*    See GlGeomBudget.h for more information.
+*
+* An addition to the software accompanying POSSIBLE SECOND EDITION TO the book
+*		3D Computer Graphics: A Mathematical Introduction with OpenGL,
+*		by S. Buss, Cambridge University Press, 2003.
+*   Not part of the book's software, and not written by its author.
+*
+* Software is "as-is" and carries no warranty.  It may be used without
+*   restriction, but if you modify it, please change the filenames to
+*   prevent confusion between different versions.
+* Web page of the book's software: http://math.ucsd.edu/~sbuss/MathCG2
+*/
+
+#include "GlGeomBudget.h"
+#include "GlGeomBase.h"
+#include <algorithm>
+#include <string.h>
+#include <utility>
+
+namespace {
+    GlGeomBudget* DefaultBudget = nullptr;
+}
+
+GlGeomBudget::GlGeomBudget(long long budgetBytes)
+    : budgetBytes(budgetBytes)
+{
+}
+
+GlGeomBudget::~GlGeomBudget()
+{
+    if (DefaultBudget == this) {
+        DefaultBudget = nullptr;
+    }
+}
+
+void GlGeomBudget::SetDefault(GlGeomBudget* budget)
+{
+    DefaultBudget = budget;
+}
+
+GlGeomBudget* GlGeomBudget::Default()
+{
+    return DefaultBudget;
+}
+
+void GlGeomBudget::SetBudget(long long bytes)
+{
+    budgetBytes = bytes;
+    EnforceBudget();
+}
+
+void GlGeomBudget::BeginFrame()
+{
+    frame++;
+    EnforceBudget();
+}
+
+// The evictable shapes not used in this frame are evicted, oldest first.
+int GlGeomBudget::EnforceBudget()
+{
+    if (numBytes <= budgetBytes || evicting) {
+        return 0;
+    }
+    struct Candidate {
+        long long lastUsedFrame;
+        GlGeomBase* shape;
+    };
+    std::vector<Candidate> candidates;
+    for (const auto& r : records) {
+        if (r.second.shape != nullptr && r.second.lastUsedFrame < frame) {
+            candidates.push_back(Candidate{ r.second.lastUsedFrame, r.second.shape });
+        }
+    }
+    std::sort(candidates.begin(), candidates.end(),
+        [](const Candidate& a, const Candidate& b) { return a.lastUsedFrame < b.lastUsedFrame; });
+
+    evicting = true;
+    int numEvicted = 0;
+    for (size_t i = 0; i < candidates.size() && numBytes > budgetBytes; i++) {
+        GlGeomBase* shape = candidates[i].shape;
+        long long before = numBytes;
+        if (evictMode == GlGeomEvictMode::CpuCopy) {
+            DropCpuCopy(shape);
+            CpuCopy& copy = cpuCopies[shape];
+            shape->EvictBuffers(&copy.vboData, &copy.eboData);
+            long long copyBytes = (long long)copy.vboData.size() + (long long)copy.eboData.size() * sizeof(unsigned int);
+            if (copyBytes == 0) {
+                cpuCopies.erase(shape);     // The mesh was out of date, so is calculated again anyway
+            }
+            cpuCopyBytes += copyBytes;
+        }
+        else {
+            shape->EvictBuffers(nullptr, nullptr);
+        }
+        numEvictions++;
+        numEvictedBytes += before - numBytes;
+        numEvicted++;
+    }
+    evicting = false;
+    return numEvicted;
+}
+
+void GlGeomBudget::RecordAllocation(const void* owner, long long bytes, GlGeomBase* shape)
+{
+    Record& r = records[owner];
+    numBytes += bytes - r.numBytes;
+    r.numBytes = bytes;
+    r.shape = shape;
+    r.lastUsedFrame = frame;        // Counts as used now, so is not evicted straight away
+    peakBytes = std::max(peakBytes, numBytes);
+    EnforceBudget();
+}
+
+void GlGeomBudget::RecordRelease(const void* owner)
+{
+    auto it = records.find(owner);
+    if (it != records.end()) {
+        numBytes -= it->second.numBytes;
+        records.erase(it);
+    }
+}
+
+void GlGeomBudget::MarkUsed(const void* owner)
+{
+    auto it = records.find(owner);
+    if (it != records.end()) {
+        it->second.lastUsedFrame = frame;
+    }
+}
+
+void GlGeomBudget::MoveOwner(const void* from, const void* to)
+{
+    auto it = records.find(from);
+    if (it != records.end()) {
+        Record r = it->second;
+        records.erase(it);
+        if (r.shape != nullptr) {
+            r.shape = (GlGeomBase*)to;
+        }
+        records[to] = r;
+    }
+    auto c = cpuCopies.find(from);
+    if (c != cpuCopies.end()) {
+        CpuCopy copy = std::move(c->second);
+        cpuCopies.erase(c);
+        cpuCopies[to] = std::move(copy);
+    }
+}
+
+void GlGeomBudget::Forget(const void* owner)
+{
+    RecordRelease(owner);
+    DropCpuCopy(owner);
+}
+
+void GlGeomBudget::DropCpuCopy(const void* owner)
+{
+    auto c = cpuCopies.find(owner);
+    if (c != cpuCopies.end()) {
+        cpuCopyBytes -= (long long)c->second.vboData.size() + (long long)c->second.eboData.size() * sizeof(unsigned int);
+        cpuCopies.erase(c);
+    }
+}
+
+bool GlGeomBudget::TakeCpuCopy(const void* owner, void* VBOdata, unsigned int* EBOdata,
+    long long vboBytes, long long eboBytes)
+{
+    auto c = cpuCopies.find(owner);
+    if (c == cpuCopies.end()) {
+        return false;
+    }
+    const CpuCopy& copy = c->second;
+    bool match = ((long long)copy.vboData.size() == vboBytes
+        && (long long)copy.eboData.size() * (long long)sizeof(unsigned int) == eboBytes);
+    if (match) {
+        memcpy(VBOdata, copy.vboData.data(), (size_t)vboBytes);
+        memcpy(EBOdata, copy.eboData.data(), (size_t)eboBytes);
+        numRestores++;
+    }
+    DropCpuCopy(owner);
+    return match;
+}
+
+void GlGeomBudget::ResetCounters()
+{
+    peakBytes = numBytes;
+    numEvictions = 0;
+    numEvictedBytes = 0;
+    numRestores = 0;
+}
@@ -0,0 +1,141 @@
+/*
+* GlGeomBudget.h - Version 0.9 - October 18, 2026
+*
+* A GlGeomBudget keeps track of the buffer memory used by the GlGeomShape
+*    classes, and keeps it under a fixed budget by releasing the meshes that
+*    have gone unused the longest.
+*    Every VBO and EBO allocation is recorded: the buffers owned by a shape,
+*    the meshes shared through GlGeomRegistry, and the pools of each GlGeomArena.
+*    Each time a shape is rendered, it is marked as used in the current frame.
+*
+* When the total is over the budget, shapes marked with GlGeomBase::SetEvictable()
+*    which have not been used in the current frame are evicted, least recently
+*    used first.  An evicted shape releases its VAO, VBO and EBO.  The next time
+*    it is rendered, its mesh is loaded again, either from a copy kept in CPU
+*    memory (GlGeomEvictMode::CpuCopy), or by calculating it again
+*    (GlGeomEvictMode::Regenerate, the default).
+*    Only meshes owned by a single shape can be evicted: not shared meshes
+*    (GlGeomRegistry.h) and not arenas (GlGeomArena.h).  SetEvictable() has no
+*    effect on a shape while it uses a shared mesh, so leave sharing off
+*    (the default) for the shapes to be evicted.
+*
+* Limitation: only whole shapes are evicted.  All the levels of a GlGeomSphereLOD
+*    or GlGeomTorusLOD are in one VBO and EBO, and a shape is used whenever any
+*    of its levels is drawn, so its high resolution levels cannot be evicted on
+*    their own.  To evict high resolution meshes, make them separate shapes
+*    (e.g. a fine GlGeomSphere for the close ups), and mark those evictable.
+*
+* How to use:
+*     GlGeomBudget meshBudget(256 << 20);       // 256 MB of VBO's and EBO's
+*     GlGeomBudget::SetDefault(&meshBudget);    // Before creating any buffers
+*     FineSpheres.SetEvictable(true);           // A separate, high resolution shape
+*     ...
+*     meshBudget.BeginFrame();                  // At the start of each frame
+*
+* The budget is only used from the render thread.  It must not be changed or
+*    deleted while there are shapes with buffers.
+*
+* An addition to the software accompanying POSSIBLE SECOND EDITION TO the book
+*		3D Computer Graphics: A Mathematical Introduction with OpenGL,
+*		by S. Buss, Cambridge University Press, 2003.
+*   Not part of the book's software, and not written by its author.
+*
+* Software is "as-is" and carries no warranty.  It may be used without
+*   restriction, but if you modify it, please change the filenames to
+*   prevent confusion between different versions.
+* Web page of the book's software: http://math.ucsd.edu/~sbuss/MathCG2
+*/
+
+#pragma once
+#ifndef GLGEOM_BUDGET_H
+#define GLGEOM_BUDGET_H
+
+#include <map>
+#include <vector>
+
+class GlGeomBase;
+
+// What happens to the mesh of an evicted shape.
+enum class GlGeomEvictMode {
+    Regenerate,         // Calculated again when next rendered
+    CpuCopy             // Read back into CPU memory, and copied back when next rendered
+};
+
+class GlGeomBudget
+{
+public:
+    GlGeomBudget(long long budgetBytes);
+    ~GlGeomBudget();
+
+    GlGeomBudget(const GlGeomBudget&) = delete;
+    GlGeomBudget& operator=(const GlGeomBudget&) = delete;
+
+    // The budget used by the GlGeomShape classes (nullptr for none, the default).
+    static void SetDefault(GlGeomBudget* budget);
+    static GlGeomBudget* Default();
+
+    void SetBudget(long long budgetBytes);
+    long long GetBudget() const { return budgetBytes; }
+    void SetEvictMode(GlGeomEvictMode mode) { evictMode = mode; }
+    GlGeomEvictMode GetEvictMode() const { return evictMode; }
+
+    // BeginFrame(): Start a new frame, and evict shapes if over the budget.
+    void BeginFrame();
+    long long GetFrame() const { return frame; }
+
+    // EnforceBudget(): Evict shapes not used in the current frame until the total
+    //    is within the budget (or nothing more can be evicted).  Returns the number evicted.
+    //    Called by BeginFrame(), and after each allocation.
+    int EnforceBudget();
+
+    // Called by the GlGeomShape classes, GlGeomRegistry and GlGeomArena.
+    //    RecordAllocation() sets the number of bytes of VBO's and EBO's held by owner
+    //    (replacing any earlier amount).  shape is the owner if it is a shape that
+    //    may be evicted, and nullptr otherwise.
+    void RecordAllocation(const void* owner, long long numBytes, GlGeomBase* shape = nullptr);
+    void RecordRelease(const void* owner);
+    void MarkUsed(const void* owner);               // Used in the current frame
+    void MoveOwner(const void* from, const void* to);   // A shape was moved (also moves its CPU copy)
+    void Forget(const void* owner);                 // The shape is deleted: also drops its CPU copy
+    void DropCpuCopy(const void* owner);            // The shape's mesh has changed
+    // TakeCpuCopy(): Copy the CPU copy of an evicted shape's mesh into the VBO and EBO data,
+    //    and drop the copy. Returns false if there is no copy of these sizes.
+    bool TakeCpuCopy(const void* owner, void* VBOdata, unsigned int* EBOdata, long long vboBytes, long long eboBytes);
+
+    // Statistics
+    long long GetNumBytes() const { return numBytes; }          // Bytes of VBO's and EBO's in use
+    long long GetPeakBytes() const { return peakBytes; }
+    int GetNumAllocations() const { return (int)records.size(); }
+    long long GetCpuCopyBytes() const { return cpuCopyBytes; }  // Bytes of evicted meshes in CPU memory
+    long long GetNumEvictions() const { return numEvictions; }
+    long long GetNumEvictedBytes() const { return numEvictedBytes; }
+    long long GetNumRestores() const { return numRestores; }    // Evicted meshes loaded from a CPU copy
+    void ResetCounters();
+
+private:
+    struct Record {
+        long long numBytes;
+        GlGeomBase* shape;          // nullptr if it cannot be evicted
+        long long lastUsedFrame;
+    };
+    struct CpuCopy {
+        std::vector<unsigned char> vboData;
+        std::vector<unsigned int> eboData;
+    };
+    std::map<const void*, Record> records;
+    std::map<const void*, CpuCopy> cpuCopies;
+
+    long long budgetBytes;
+    GlGeomEvictMode evictMode = GlGeomEvictMode::Regenerate;
+    long long frame = 0;
+    bool evicting = false;          // Releasing buffers while evicting does not call EnforceBudget again
+
+    long long numBytes = 0;
+    long long peakBytes = 0;
+    long long cpuCopyBytes = 0;
+    long long numEvictions = 0;
+    long long numEvictedBytes = 0;
+    long long numRestores = 0;
+};
+
+#endif  // GLGEOM_BUDGET_H
@@ -0,0 +1,254 @@
+/*
+* GlGeomConstMesh.h - Version 0.9 - October 18, 2026
+*
+* Sphere and torus meshes generated at compile time.
+*    ConstSphereMesh<Slices, Stacks, Layout> and ConstTorusMesh<Sides, Rings, Layout>
+*    are literal types holding the same vertex data and GL_TRIANGLES elements
+*    as GlGeomSphere and GlGeomTorus calculate at run time.  Declared as
+*    static constexpr objects, they are calculated by the compiler and placed
+*    in read-only data, which is shared by all processes running the program.
+*    Nothing is calculated when the mesh is loaded into the VBO and EBO:
+*    GlGeomBase copies the data directly.
+*
+* How to use:
+*     static constexpr ConstSphereMesh<10, 10> SunMesh{};
+*     static constexpr ConstTorusMesh<8, 20> RingMesh{ 0.02f };
+*     GlGeomSphere Sun(10, 10);
+*     GlGeomTorus Ring(8, 20, 0.02f);
+*     ...
+*     Sun.SetConstMesh(SunMesh);            // Before InitializeAttribLocations()
+*     Ring.SetConstMesh(RingMesh);
+*
+*    The layout must have normals if normals are used, and must have texture
+*    coordinates exactly if texture coordinates are used.  Otherwise (and
+*    after a Remesh() to a different mesh) the mesh is calculated as usual.
+*    Large meshes may need a higher compiler limit for constexpr evaluation
+*    (e.g., -fconstexpr-ops-limit for gcc).
+*
+* An addition to the software accompanying POSSIBLE SECOND EDITION TO the book
+*		3D Computer Graphics: A Mathematical Introduction with OpenGL,
+*		by S. Buss, Cambridge University Press, 2003.
+*   Not part of the book's software, and not written by its author.
+*
+* Software is "as-is" and carries no warranty.  It may be used without
+*   restriction, but if you modify it, please change the filenames to
+*   prevent confusion between different versions.
+* Web page of the book's software: http://math.ucsd.edu/~sbuss/MathCG2
+*/
+
+#pragma once
+#ifndef GLGEOM_CONST_MESH_H
+#define GLGEOM_CONST_MESH_H
+
+// The vertex attributes in a compile time mesh.
+//    Positions come first, then normals, then texture coordinates, all as floats.
+enum class GlGeomConstLayout {
+    Positions,
+    PositionsNormals,
+    PositionsTexCoords,
+    PositionsNormalsTexCoords
+};
+
+constexpr bool GlGeomConstHasNormals(GlGeomConstLayout layout) {
+    return layout == GlGeomConstLayout::PositionsNormals || layout == GlGeomConstLayout::PositionsNormalsTexCoords;
+}
+constexpr bool GlGeomConstHasTexCoords(GlGeomConstLayout layout) {
+    return layout == GlGeomConstLayout::PositionsTexCoords || layout == GlGeomConstLayout::PositionsNormalsTexCoords;
+}
+constexpr int GlGeomConstStride(GlGeomConstLayout layout) {
+    return 3 + (GlGeomConstHasNormals(layout) ? 3 : 0) + (GlGeomConstHasTexCoords(layout) ? 2 : 0);
+}
+
+// The data of a compile time mesh, as used by GlGeomBase.
+struct GlGeomConstMeshData {
+    const float* vertices;
+    int numVertices;
+    int stride;                 // In floats
+    int normalOffset;           // -1 if no normals
+    int texCoordsOffset;        // -1 if no texture coordinates
+    const unsigned int* elements;
+    int numElements;
+};
+
+// Sine and cosine which can be evaluated at compile time.
+//    The angle is reduced to [-pi,pi], then a Taylor series is summed.
+//    Accurate to about 1.0e-12, which is plenty for float vertex data.
+constexpr double GlGeomConstSin(double x) {
+    const double pi = 3.1415926535897932384626433832795028841971693993751;
+    while (x > pi) {
+        x -= 2.0*pi;
+    }
+    while (x < -pi) {
+        x += 2.0*pi;
+    }
+    double term = x;
+    double sum = x;
+    for (int n = 1; n < 14; n++) {
+        term *= -x * x / (double)((2 * n)*(2 * n + 1));
+        sum += term;
+    }
+    return sum;
+}
+constexpr double GlGeomConstCos(double x) {
+    return GlGeomConstSin(x + 0.5*3.1415926535897932384626433832795028841971693993751);
+}
+
+// ConstSphereMesh
+//    The same mesh as GlGeomSphere(Slices, Stacks).
+template<int Slices, int Stacks, GlGeomConstLayout Layout = GlGeomConstLayout::Positions>
+class ConstSphereMesh
+{
+public:
+    static_assert(Slices >= 3 && Slices <= 255 && Stacks >= 3 && Stacks <= 255, "Slices and stacks must be 3 to 255");
+    static const bool HasNormals = GlGeomConstHasNormals(Layout);
+    static const bool HasTexCoords = GlGeomConstHasTexCoords(Layout);
+    static const int Stride = GlGeomConstStride(Layout);
+    static const int NormalOffset = HasNormals ? 3 : -1;
+    static const int TexCoordsOffset = HasTexCoords ? (HasNormals ? 6 : 3) : -1;
+    static const int NumVertices = HasTexCoords ? (Slices + 1)*(Stacks - 1) + 2 : Slices * (Stacks - 1) + 2;
+    static const int NumElements = 6 * Slices*(Stacks - 1);
+
+    float vertices[NumVertices * Stride];
+    unsigned int elements[NumElements];
+
+    constexpr ConstSphereMesh();
+
+    GlGeomConstMeshData GetData() const {
+        return GlGeomConstMeshData{ vertices, NumVertices, Stride, NormalOffset, TexCoordsOffset,
+                                    elements, NumElements };
+    }
+
+private:
+    // The same vertex numbering as GlGeomSphere::GetVertexNumber()
+    static constexpr int VertexNumber(int i, int j) {
+        return (j == 0) ? 0 : (j == Stacks) ? 1 : (Stacks - 1)*(HasTexCoords ? i : (i%Slices)) + j + 1;
+    }
+};
+
+template<int Slices, int Stacks, GlGeomConstLayout Layout>
+constexpr ConstSphereMesh<Slices, Stacks, Layout>::ConstSphereMesh() : vertices{}, elements{}
+{
+    const double pi = 3.1415926535897932384626433832795028841971693993751;
+    for (int i = 0; i <= Slices; i++) {
+        double theta = (double)(i%Slices) * 2.0 * pi / (double)Slices;
+        double costheta = GlGeomConstCos(theta);
+        double sintheta = GlGeomConstSin(theta);
+        for (int j = 0; j <= Stacks; j++) {
+            if ((j == 0 || j == Stacks) && i != 0) {
+                continue;       // North or South pole -- duplicate not needed
+            }
+            double phi = (double)j * pi / (double)Stacks;
+            double cosphi = GlGeomConstCos(phi);
+            double sinphi = (j < Stacks) ? GlGeomConstSin(phi) : 0.0;
+            float* v = vertices + Stride * VertexNumber(i, j);
+            v[0] = (float)(-sintheta * sinphi);
+            v[1] = (float)(-cosphi);
+            v[2] = (float)(-costheta * sinphi);
+            if (HasNormals) {
+                v[3] = v[0];
+                v[4] = v[1];
+                v[5] = v[2];
+            }
+            if (HasTexCoords) {
+                v[TexCoordsOffset] = (j != 0 && j != Stacks) ? (float)i / (float)Slices : 0.5f;
+                v[TexCoordsOffset + 1] = (float)j / (float)Stacks;
+            }
+        }
+    }
+
+    // GL_TRIANGLES, in the same order as GlGeomSphere::CalcVboAndEbo()
+    int k = 0;
+    for (int i = 0; i < Slices; i++) {
+        for (int j = 0; j < Stacks - 1; j++) {
+            elements[k++] = VertexNumber(i, j);
+            elements[k++] = VertexNumber(i + 1, j + 1);
+            elements[k++] = VertexNumber(i, j + 1);
+
+            elements[k++] = VertexNumber(i, j + 1);
+            elements[k++] = VertexNumber(i + 1, j + 1);
+            elements[k++] = VertexNumber(i + 1, j + 2);
+        }
+    }
+}
+
+// ConstTorusMesh
+//    The same mesh as GlGeomTorus(Sides, Rings, minorRadius).
+//    The minor radius is a constructor argument, since floats cannot be template parameters.
+template<int Sides, int Rings, GlGeomConstLayout Layout = GlGeomConstLayout::Positions>
+class ConstTorusMesh
+{
+public:
+    static_assert(Sides >= 3 && Sides <= 255 && Rings >= 3 && Rings <= 255, "Sides and rings must be 3 to 255");
+    static const bool HasNormals = GlGeomConstHasNormals(Layout);
+    static const bool HasTexCoords = GlGeomConstHasTexCoords(Layout);
+    static const int Stride = GlGeomConstStride(Layout);
+    static const int NormalOffset = HasNormals ? 3 : -1;
+    static const int TexCoordsOffset = HasTexCoords ? (HasNormals ? 6 : 3) : -1;
+    static const int NumVertices = HasTexCoords ? (Rings + 1)*(Sides + 1) : Rings * Sides;
+    static const int NumElements = 6 * Rings * Sides;
+
+    float minorRadius;
+    float vertices[NumVertices * Stride];
+    unsigned int elements[NumElements];
+
+    constexpr ConstTorusMesh(float minorRadius);
+
+    GlGeomConstMeshData GetData() const {
+        return GlGeomConstMeshData{ vertices, NumVertices, Stride, NormalOffset, TexCoordsOffset,
+                                    elements, NumElements };
+    }
+};
+
+template<int Sides, int Rings, GlGeomConstLayout Layout>
+constexpr ConstTorusMesh<Sides, Rings, Layout>::ConstTorusMesh(float radius)
+    : minorRadius(radius), vertices{}, elements{}
+{
+    const double pi = 3.1415926535897932384626433832795028841971693993751;
+    // Around each ring, starting with the ring at x==0 and z<0, and at the inner seam.
+    float* toPtr = vertices;
+    int stopRings = HasTexCoords ? Rings : Rings - 1;
+    int stopSides = HasTexCoords ? Sides : Sides - 1;
+    for (int i = 0; i <= stopRings; i++) {
+        double theta = 2.0 * pi * (double)(i%Rings) / (double)Rings;
+        double c = -GlGeomConstCos(theta);
+        double s = -GlGeomConstSin(theta);
+        for (int j = 0; j <= stopSides; j++, toPtr += Stride) {
+            double phi = 2.0 * pi * (double)(j%Sides) / (double)Sides;
+            double cphi = -GlGeomConstCos(phi);
+            double sphi = -GlGeomConstSin(phi);
+            toPtr[0] = (float)(s * (1.0 + radius * cphi));
+            toPtr[1] = (float)(radius * sphi);
+            toPtr[2] = (float)(c * (1.0 + radius * cphi));
+            if (HasNormals) {
+                toPtr[3] = (float)(s * cphi);
+                toPtr[4] = (float)sphi;
+                toPtr[5] = (float)(c * cphi);
+            }
+            if (HasTexCoords) {
+                toPtr[TexCoordsOffset] = (float)i / (float)Rings;
+                toPtr[TexCoordsOffset + 1] = (float)j / (float)Sides;
+            }
+        }
+    }
+
+    // GL_TRIANGLES, in the same order as GlGeomTorus::CalcVboAndEbo()
+    int k = 0;
+    int ringDelta = HasTexCoords ? Sides + 1 : Sides;
+    for (int ii = 0; ii < Rings; ii++) {
+        int iii = HasTexCoords ? (ii + 1) : ((ii + 1) % Rings);
+        int leftR = ii * ringDelta;
+        int rightR = iii * ringDelta;
+        for (int j = 0; j < Sides; j++) {
+            int jj = HasTexCoords ? (j + 1) : ((j + 1) % Sides);
+            elements[k++] = rightR + j;
+            elements[k++] = leftR + jj;
+            elements[k++] = leftR + j;
+
+            elements[k++] = rightR + j;
+            elements[k++] = rightR + jj;
+            elements[k++] = leftR + jj;
+        }
+    }
+}
+
+#endif  // GLGEOM_CONST_MESH_H
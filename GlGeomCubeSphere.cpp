@@ -0,0 +1,228 @@
+/*
+* GlGeomCubeSphere.cpp - Version 0.9 - October 18, 2026
+*
+* C++ class for rendering cube spheres in Modern OpenGL.
+*    See GlGeomCubeSphere.h for more information.
+*
+* An addition to the software accompanying POSSIBLE SECOND EDITION TO the book
+*		3D Computer Graphics: A Mathematical Introduction with OpenGL,
+*		by S. Buss, Cambridge University Press, 2003.
+*   Not part of the book's software, and not written by its author.
+*
+* Software is "as-is" and carries no warranty.  It may be used without
+*   restriction, but if you modify it, please change the filenames to
+*   prevent confusion between different versions.
+* Web page of the book's software: http://math.ucsd.edu/~sbuss/MathCG2
+*/
+
+// Use the static library (so glew32.dll is not needed):
+#define GLEW_STATIC
+#include <GL/glew.h>
+#include <GLFW/glfw3.h>
+
+#include "MathMisc.h"
+#include "assert.h"
+#include <stdio.h>
+#include <vector>
+
+#include "GlGeomCubeSphere.h"
+#include "GlGeomParallel.h"
+
+namespace {
+    // The faces of the cube [0,n]^3 (in grid units), in the order +x,-x,+y,-y,+z,-z.
+    //    Grid point (i,j) of a face is at origin*n + i*u + j*v.
+    //    u x v points out of the cube, so the triangles are counterclockwise from outside.
+    struct CubeFace {
+        int origin[3];
+        int u[3];
+        int v[3];
+    };
+    const CubeFace CubeFaces[6] = {
+        { { 1, 0, 1 }, { 0, 0, -1 }, { 0, 1, 0 } },     // +x
+        { { 0, 0, 0 }, { 0, 0, 1 }, { 0, 1, 0 } },      // -x
+        { { 0, 1, 1 }, { 1, 0, 0 }, { 0, 0, -1 } },     // +y
+        { { 0, 0, 0 }, { 1, 0, 0 }, { 0, 0, 1 } },      // -y
+        { { 0, 0, 1 }, { 1, 0, 0 }, { 0, 1, 0 } },      // +z
+        { { 1, 0, 0 }, { -1, 0, 0 }, { 0, 1, 0 } } };   // -z
+}
+
+GlGeomCubeSphere::GlGeomCubeSphere(int divisions)
+{
+    numDivisions = ClampRange(divisions, 1, 128);
+}
+
+void GlGeomCubeSphere::Remesh(int divisions)
+{
+    divisions = ClampRange(divisions, 1, 128);
+    if (divisions == numDivisions) {
+        return;
+    }
+    numDivisions = divisions;
+    SetMeshDirty();
+}
+
+std::string GlGeomCubeSphere::GetShapeKey() const
+{
+    char key[40];
+    snprintf(key, sizeof(key), "GlGeomCubeSphere %d", numDivisions);
+    return std::string(key);
+}
+
+// Create the VBO and EBO data for the cube sphere.
+// See GlGeomBase.h for more information.
+// Each of the six faces is calculated separately, possibly in parallel.
+void GlGeomCubeSphere::CalcVboAndEbo(float* VBOdataBuffer, unsigned int* EBOdataBuffer,
+    int vertPosOffset, int vertNormalOffset, int vertTexCoordsOffset, unsigned int stride)
+{
+    assert(vertPosOffset >= 0 && stride > 0);
+    const int n = numDivisions;
+
+    // Grid coordinates on the cube [-1,1]^3, at equal angles.
+    //    Symmetric, with exact values at -1, 0 and 1, so that the vertices
+    //    on the edges of the faces are the same from both faces.
+    std::vector<double> coords(n + 1);
+    for (int k = 0; 2 * k <= n; k++) {
+        double c = (2 * k == n) ? 0.0 : tan(0.25*PI*(2.0*k / n - 1.0));
+        coords[k] = (k == 0) ? -1.0 : c;
+        coords[n - k] = -coords[k];
+    }
+
+    int numVertices = (vertTexCoordsOffset >= 0) ? GetNumVerticesTexCoords() : GetNumVerticesNoTexCoords();
+    const double* coordsPtr = coords.data();
+    GlGeomParallelFor(6, numVertices, [=](int face) {
+        CalcFace(face, coordsPtr, VBOdataBuffer, EBOdataBuffer, vertPosOffset, vertNormalOffset, vertTexCoordsOffset, stride);
+    });
+}
+
+// Calculate the vertices and the triangles of one face of the cube.
+void GlGeomCubeSphere::CalcFace(int face, const double* coords, float* VBOdataBuffer, unsigned int* EBOdataBuffer,
+    int vertPosOffset, int vertNormalOffset, int vertTexCoordsOffset, unsigned int stride) const
+{
+    bool calcNormals = (vertNormalOffset >= 0);
+    bool calcTexCoords = (vertTexCoordsOffset >= 0);
+    const int n = numDivisions;
+    const CubeFace& cf = CubeFaces[face];
+    float sAtlas = (float)(face % 3);
+    float tAtlas = (float)(face / 3);
+
+    std::vector<unsigned int> vertNumbers(GetNumVerticesPerFace());
+    unsigned int* vertNum = vertNumbers.data();
+    for (int j = 0; j <= n; j++) {
+        for (int i = 0; i <= n; i++, vertNum++) {
+            int lattice[3];
+            for (int k = 0; k < 3; k++) {
+                lattice[k] = cf.origin[k] * n + i * cf.u[k] + j * cf.v[k];
+            }
+            if (!GetVertexNumber(face, lattice, i, j, calcTexCoords, vertNum)) {
+                continue;       // Calculated by another face
+            }
+            double x = coords[lattice[0]];
+            double y = coords[lattice[1]];
+            double z = coords[lattice[2]];
+            double normInv = 1.0 / sqrt(x*x + y * y + z * z);
+            x *= normInv;
+            y *= normInv;
+            z *= normInv;
+            float* basePtr = VBOdataBuffer + stride * (*vertNum);
+            float* vPtr = basePtr + vertPosOffset;
+            *vPtr = (float)x;
+            *(vPtr + 1) = (float)y;
+            *(vPtr + 2) = (float)z;
+            if (calcNormals) {
+                float* nPtr = basePtr + vertNormalOffset;
+                *nPtr = (float)x;
+                *(nPtr + 1) = (float)y;
+                *(nPtr + 2) = (float)z;
+            }
+            if (calcTexCoords) {
+                float* tcPtr = basePtr + vertTexCoordsOffset;
+                *tcPtr = (sAtlas + (float)i / (float)n) / 3.0f;
+                *(tcPtr + 1) = (tAtlas + (float)j / (float)n) / 2.0f;
+            }
+        }
+    }
+
+    if (EBOdataBuffer == nullptr) {
+        return;
+    }
+
+    // Two triangles for each square of the grid.
+    unsigned int* toEbo = EBOdataBuffer + face * GetNumElementsInFace();
+    const unsigned int* row = vertNumbers.data();
+    for (int j = 0; j < n; j++) {
+        const unsigned int* nextRow = row + (n + 1);
+        for (int i = 0; i < n; i++) {
+            *(toEbo++) = row[i];
+            *(toEbo++) = row[i + 1];
+            *(toEbo++) = nextRow[i + 1];
+
+            *(toEbo++) = row[i];
+            *(toEbo++) = nextRow[i + 1];
+            *(toEbo++) = nextRow[i];
+        }
+        row = nextRow;
+    }
+    assert(toEbo - EBOdataBuffer == (face + 1) * GetNumElementsInFace());
+}
+
+// Calculate the vertex number for the grid point (i,j) of a face.
+// With texture coordinates, each face has its own vertices, numbered row by row.
+// Otherwise the vertices are shared: first the 8 corners of the cube, then
+//     the vertices inside the 12 edges, then the vertices inside the 6 faces.
+//     These are found from the grid point on the cube, lattice[] in [0,n]^3.
+// Returns false if the vertex is calculated by a different face.
+//     (The lowest numbered face containing a vertex calculates it.)
+bool GlGeomCubeSphere::GetVertexNumber(int face, const int* lattice, int i, int j,
+    bool calcTexCoords, unsigned int* retVertNum) const
+{
+    const int n = numDivisions;
+    if (calcTexCoords) {
+        *retVertNum = face * GetNumVerticesPerFace() + j * (n + 1) + i;
+        return true;
+    }
+
+    int numOnBoundary = 0;
+    int freeAxis = -1;
+    int owner = 6;
+    for (int k = 0; k < 3; k++) {
+        if (lattice[k] == 0 || lattice[k] == n) {
+            numOnBoundary++;
+            owner = Min(owner, 2 * k + (lattice[k] == 0 ? 1 : 0));
+        }
+        else {
+            freeAxis = k;
+        }
+    }
+    if (numOnBoundary == 3) {
+        *retVertNum = (lattice[0] / n) + 2 * (lattice[1] / n) + 4 * (lattice[2] / n);
+    }
+    else if (numOnBoundary == 2) {
+        int k1 = (freeAxis == 0) ? 1 : 0;
+        int k2 = (freeAxis == 2) ? 1 : 2;
+        int edge = 4 * freeAxis + (lattice[k1] == n ? 1 : 0) + (lattice[k2] == n ? 2 : 0);
+        *retVertNum = 8 + edge * (n - 1) + (lattice[freeAxis] - 1);
+    }
+    else {
+        *retVertNum = 8 + 12 * (n - 1) + face * (n - 1)*(n - 1) + (j - 1)*(n - 1) + (i - 1);
+    }
+    return (owner == face);
+}
+
+void GlGeomCubeSphere::InitializeAttribLocations(
+    unsigned int pos_loc, unsigned int normal_loc, unsigned int texcoords_loc)
+{
+    GlGeomBase::InitializeAttribLocations(pos_loc, normal_loc, texcoords_loc);
+}
+
+void GlGeomCubeSphere::Render()
+{
+    PreRender();
+    GlGeomBase::Render();
+}
+
+void GlGeomCubeSphere::RenderFace(int face)
+{
+    assert(face >= 0 && face < 6);
+    PreRender();
+    GlGeomBase::RenderEBO(GL_TRIANGLES, GetNumElementsInFace(), face*GetNumElementsInFace());
+}
@@ -0,0 +1,96 @@
+/*
+* GlGeomCubeSphere.h - Version 0.9 - October 18, 2026
+*
+* C++ class for rendering cube spheres in Modern OpenGL.
+*   A cube sphere is a unit sphere formed by dividing each face of a
+*   cube into a grid of squares, and pushing the vertices out to the sphere.
+*   The grid is spaced by equal angles (the "tangent warp"), so the
+*   squares are close to the same size everywhere on the sphere.
+*   There are no poles, and no thin triangles.
+*
+*   There are 12*divisions*divisions triangles.
+*   The faces are calculated in parallel for large meshes (see GlGeomParallel.h).
+*
+*   Without texture coordinates, all vertices are shared by the triangles around them.
+*   With texture coordinates, each face of the cube has its own vertices,
+*   and the texture is an atlas of the six faces in three columns and two rows:
+*          +x  -x  +y     (bottom row, t from 0 to 1/2)
+*          -y  +z  -z     (top row, t from 1/2 to 1)
+*
+* An addition to the software accompanying POSSIBLE SECOND EDITION TO the book
+*		3D Computer Graphics: A Mathematical Introduction with OpenGL,
+*		by S. Buss, Cambridge University Press, 2003.
+*   Not part of the book's software, and not written by its author.
+*
+* Software is "as-is" and carries no warranty.  It may be used without
+*   restriction, but if you modify it, please change the filenames to
+*   prevent confusion between different versions.
+* Web page of the book's software: http://math.ucsd.edu/~sbuss/MathCG2
+*/
+
+#pragma once
+#ifndef GLGEOM_CUBE_SPHERE_H
+#define GLGEOM_CUBE_SPHERE_H
+
+#include "GlGeomBase.h"
+
+// GlGeomCubeSphere
+// How to use:
+//     * Call the constructor GlGeomCubeSphere() or Remesh() to set the number of
+//          divisions of each edge of the cube.
+//     * Then call InitializeAttribLocations(), exactly as for GlGeomSphere.
+//     * Call Render() to render the sphere.
+
+class GlGeomCubeSphere : public GlGeomBase
+{
+public:
+    GlGeomCubeSphere() : GlGeomCubeSphere(4) {}
+    GlGeomCubeSphere(int divisions);
+
+    // Remesh: change the number of divisions (from 1 to 128).
+    void Remesh(int divisions);
+
+    void InitializeAttribLocations(
+        unsigned int pos_loc, unsigned int normal_loc = UINT_MAX, unsigned int texcoords_loc = UINT_MAX);
+
+    // Render the sphere.  Must call InitializeAttribLocations first.
+    void Render();
+    // Render the triangles from one face of the cube (face = 0,...,5 for +x,-x,+y,-y,+z,-z).
+    void RenderFace(int face);
+
+    int GetNumDivisions() const { return numDivisions; }
+
+    int GetNumElements() const { return 36 * numDivisions*numDivisions; }
+    int GetNumVerticesTexCoords() const { return 6 * GetNumVerticesPerFace(); }
+    int GetNumVerticesNoTexCoords() const { return 6 * numDivisions*numDivisions + 2; }
+
+    int GetNumTriangles() const { return 12 * numDivisions*numDivisions; }
+    int GetNumElementsInFace() const { return 6 * numDivisions*numDivisions; }
+    int GetNumVerticesPerFace() const { return (numDivisions + 1)*(numDivisions + 1); }
+
+    bool NormalsEqualPositions() const { return true; }
+    bool FitsUnitCube() const { return true; }
+
+    std::string GetShapeKey() const;
+
+    // Can be moved (e.g., kept in a std::vector), but not copied.
+    GlGeomCubeSphere(GlGeomCubeSphere&&) = default;
+    GlGeomCubeSphere& operator=(GlGeomCubeSphere&&) = default;
+
+private:
+    void CalcVboAndEbo(float* VBOdataBuffer, unsigned int* EBOdataBuffer,
+        int vertPosOffset, int vertNormalOffset, int vertTexCoordsOffset,
+        unsigned int stride);
+    void CalcFace(int face, const double* coords, float* VBOdataBuffer, unsigned int* EBOdataBuffer,
+        int vertPosOffset, int vertNormalOffset, int vertTexCoordsOffset,
+        unsigned int stride) const;
+    bool GetVertexNumber(int face, const int* lattice, int i, int j, bool calcTexCoords, unsigned int* retVertNum) const;
+
+    GlGeomCubeSphere(const GlGeomCubeSphere&) = delete;
+    GlGeomCubeSphere& operator=(const GlGeomCubeSphere&) = delete;
+
+private:
+    int numDivisions;       // Number of squares along each edge of a face of the cube
+};
+
+#endif  // GLGEOM_CUBE_SPHERE_H
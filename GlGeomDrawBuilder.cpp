@@ -0,0 +1,247 @@
+/*
+* GlGeomDrawBuilder.cpp - Version 0.9 - October 18, 2026
+*
+* Gathers draws of GlGeomShape objects and submits them with multi-draw indirect.
+*    See GlGeomDrawBuilder.h for more information.
+*
+* An addition to the software accompanying POSSIBLE SECOND EDITION TO the book
+*		3D Computer Graphics: A Mathematical Introduction with OpenGL,
+*		by S. Buss, Cambridge University Press, 2003.
+*   Not part of the book's software, and not written by its author.
+*
+* Software is "as-is" and carries no warranty.  It may be used without
+*   restriction, but if you modify it, please change the filenames to
+*   prevent confusion between different versions.
+* Web page of the book's software: http://math.ucsd.edu/~sbuss/MathCG2
+*/
+
+// Use the static library (so glew32.dll is not needed):
+#define GLEW_STATIC
+#include <GL/glew.h>
+#include <GLFW/glfw3.h>
+
+#include <algorithm>
+#include "GlGeomDrawBuilder.h"
+#include "GlGeomBase.h"
+#include "GlGeomStateCache.h"
+#include "assert.h"
+
+namespace {
+    bool IndirectEnabled = true;
+    int StorageAlignment = 0;       // GL_SHADER_STORAGE_BUFFER_OFFSET_ALIGNMENT, in floats (0 if not known yet)
+}
+
+GlGeomDrawBuilder::~GlGeomDrawBuilder()
+{
+    if (indirectBuffer != 0) {
+        glDeleteBuffers(1, &indirectBuffer);
+    }
+    if (storageBuffer != 0) {
+        glDeleteBuffers(1, &storageBuffer);
+    }
+}
+
+bool GlGeomDrawBuilder::IsIndirectSupported()
+{
+    return GLEW_VERSION_4_3 || (GLEW_ARB_multi_draw_indirect && GLEW_ARB_base_instance);
+}
+
+void GlGeomDrawBuilder::SetIndirectEnabled(bool enabled)
+{
+    IndirectEnabled = enabled;
+}
+
+// The per-draw data also needs shader storage buffers (in OpenGL 4.3).
+bool GlGeomDrawBuilder::UsesIndirect() const
+{
+    if (!IndirectEnabled || !IsIndirectSupported()) {
+        return false;
+    }
+    return !hasDrawData || GLEW_VERSION_4_3 || GLEW_ARB_shader_storage_buffer_object;
+}
+
+void GlGeomDrawBuilder::SetInstanceAttribLocations(unsigned int matrix_loc, unsigned int color_loc, unsigned int scale_loc)
+{
+    instanceMatrixLoc = matrix_loc;
+    instanceColorLoc = color_loc;
+    instanceScaleLoc = scale_loc;
+}
+
+void GlGeomDrawBuilder::Clear()
+{
+    draws.clear();
+    hasDrawData = false;
+}
+
+// The shape's mesh is brought up to date now, since its ranges in an arena may change.
+void GlGeomDrawBuilder::Add(GlGeomBase& shape, int firstInstance, int instanceCount, int group,
+    const float* drawData)
+{
+    shape.PreRender();          // Also loads an evicted mesh again
+    int first, num;
+    shape.GetElementGroup(group, &first, &num);
+    draws.emplace_back();
+    Draw& d = draws.back();
+    d.vao = shape.GetVAO();
+    d.cmd.count = num;
+    d.cmd.instanceCount = instanceCount;
+    d.cmd.firstIndex = shape.GetFirstElement() + first;
+    d.cmd.baseVertex = shape.GetBaseVertex();
+    d.cmd.baseInstance = firstInstance;
+    for (int i = 0; i < 4; i++) {
+        d.data[i] = (drawData != nullptr) ? drawData[i] : 0.0f;
+    }
+    hasDrawData = hasDrawData || (drawData != nullptr);
+}
+
+// Sort the draws by VAO, and put the commands and the per-draw data in submission order.
+//    gl_DrawID starts at zero in each glMultiDrawElementsIndirect, so each batch's
+//    per-draw data starts at an offset which can be bound with glBindBufferRange.
+void GlGeomDrawBuilder::MakeBatches()
+{
+    int numDraws = (int)draws.size();
+    order.resize(numDraws);
+    for (int i = 0; i < numDraws; i++) {
+        order[i] = i;
+    }
+    std::stable_sort(order.begin(), order.end(),
+        [this](int a, int b) { return draws[a].vao < draws[b].vao; });
+
+    // The batches are only aligned when their per-draw data is bound from a storage buffer.
+    int alignment = 4;
+    if (hasDrawData && UsesIndirect()) {
+        if (StorageAlignment == 0) {
+            GLint align = 256;
+            glGetIntegerv(GL_SHADER_STORAGE_BUFFER_OFFSET_ALIGNMENT, &align);
+            StorageAlignment = std::max((int)align, 16) / sizeof(float);
+        }
+        alignment = StorageAlignment;
+    }
+
+    commands.resize(numDraws);
+    batchStarts.clear();
+    batchDataOffsets.clear();
+    drawDataBuffer.clear();
+    for (int k = 0; k < numDraws; k++) {
+        const Draw& d = draws[order[k]];
+        if (k == 0 || d.vao != draws[order[k - 1]].vao) {
+            batchStarts.push_back(k);
+            int offset = (((int)drawDataBuffer.size() + alignment - 1) / alignment) * alignment;
+            drawDataBuffer.resize(offset);
+            batchDataOffsets.push_back(offset);
+        }
+        commands[k] = d.cmd;
+        drawDataBuffer.insert(drawDataBuffer.end(), d.data, d.data + 4);
+    }
+    batchStarts.push_back(numDraws);
+}
+
+int GlGeomDrawBuilder::Submit(unsigned int instanceBuffer)
+{
+    if (draws.empty()) {
+        return 0;
+    }
+    MakeBatches();
+    bool indirect = UsesIndirect();
+    if (indirect) {
+        UploadStream(GL_DRAW_INDIRECT_BUFFER, &indirectBuffer, &indirectCapacity,
+            commands.data(), (long long)commands.size() * sizeof(GlGeomDrawCommand));
+        glBindBuffer(GL_DRAW_INDIRECT_BUFFER, indirectBuffer);
+        if (hasDrawData) {
+            UploadStream(GL_SHADER_STORAGE_BUFFER, &storageBuffer, &storageCapacity,
+                drawDataBuffer.data(), (long long)drawDataBuffer.size() * sizeof(float));
+        }
+    }
+
+    int numCalls = 0;
+    int numBatches = (int)batchStarts.size() - 1;
+    for (int b = 0; b < numBatches; b++) {
+        int numInBatch = batchStarts[b + 1] - batchStarts[b];
+        GlGeomStateCache::BindVertexArray(draws[order[batchStarts[b]]].vao);
+        if (indirect) {
+            if (instanceBuffer != 0) {
+                GlGeomInstanceBuffer::SetAttribPointers(instanceBuffer, 0,
+                    instanceMatrixLoc, instanceColorLoc, instanceScaleLoc);
+            }
+            SubmitIndirect(b, numInBatch);
+            numCalls++;
+        }
+        else {
+            numCalls += SubmitFallback(b, numInBatch, instanceBuffer);
+        }
+        if (instanceBuffer != 0) {
+            GlGeomInstanceBuffer::DisableAttribs(instanceMatrixLoc, instanceColorLoc, instanceScaleLoc);
+        }
+    }
+    if (!GlGeomStateCache::IsEnabled()) {
+        GlGeomStateCache::BindVertexArray(0);
+    }
+    if (indirect) {
+        glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+    }
+    return numCalls;
+}
+
+void GlGeomDrawBuilder::SubmitIndirect(int batch, int numInBatch)
+{
+    if (hasDrawData) {
+        glBindBufferRange(GL_SHADER_STORAGE_BUFFER, drawDataBinding, storageBuffer,
+            (GLintptr)(batchDataOffsets[batch] * sizeof(float)), (GLsizeiptr)(4 * numInBatch * sizeof(float)));
+    }
+    glMultiDrawElementsIndirect(GL_TRIANGLES, GL_UNSIGNED_INT,
+        (void*)(batchStarts[batch] * sizeof(GlGeomDrawCommand)), (GLsizei)numInBatch, sizeof(GlGeomDrawCommand));
+}
+
+// Without indirect drawing: one glMultiDrawElementsBaseVertex if every draw is a single
+//    instance with no instance attributes and no per-draw data, and otherwise one draw per command.
+int GlGeomDrawBuilder::SubmitFallback(int batch, int numInBatch, unsigned int instanceBuffer)
+{
+    const GlGeomDrawCommand* cmds = commands.data() + batchStarts[batch];
+    const float* data = drawDataBuffer.data() + batchDataOffsets[batch];
+    bool useUniform = hasDrawData && drawDataUniform >= 0;
+    bool singleInstances = true;
+    for (int i = 0; i < numInBatch; i++) {
+        singleInstances = singleInstances && (cmds[i].instanceCount == 1);
+    }
+    if (instanceBuffer == 0 && !useUniform && singleInstances) {
+        fallbackCounts.resize(numInBatch);
+        fallbackOffsets.resize(numInBatch);
+        fallbackBaseVertices.resize(numInBatch);
+        for (int i = 0; i < numInBatch; i++) {
+            fallbackCounts[i] = cmds[i].count;
+            fallbackOffsets[i] = (const void*)(cmds[i].firstIndex * sizeof(unsigned int));
+            fallbackBaseVertices[i] = cmds[i].baseVertex;
+        }
+        glMultiDrawElementsBaseVertex(GL_TRIANGLES, fallbackCounts.data(), GL_UNSIGNED_INT,
+            fallbackOffsets.data(), (GLsizei)numInBatch, fallbackBaseVertices.data());
+        return 1;
+    }
+    for (int i = 0; i < numInBatch; i++) {
+        if (instanceBuffer != 0) {
+            GlGeomInstanceBuffer::SetAttribPointers(instanceBuffer, cmds[i].baseInstance,
+                instanceMatrixLoc, instanceColorLoc, instanceScaleLoc);
+        }
+        if (useUniform) {
+            glUniform4fv(drawDataUniform, 1, data + 4 * i);
+        }
+        glDrawElementsInstancedBaseVertex(GL_TRIANGLES, (GLsizei)cmds[i].count, GL_UNSIGNED_INT,
+            (void*)(cmds[i].firstIndex * sizeof(unsigned int)), (GLsizei)cmds[i].instanceCount, cmds[i].baseVertex);
+    }
+    return numInBatch;
+}
+
+// Upload data that is used once: the buffer is orphaned, and only grows.
+void GlGeomDrawBuilder::UploadStream(unsigned int target, unsigned int* buffer, long long* capacity,
+    const void* data, long long numBytes)
+{
+    if (*buffer == 0) {
+        glGenBuffers(1, buffer);
+    }
+    if (numBytes > *capacity) {
+        *capacity = numBytes + numBytes / 2;
+    }
+    glBindBuffer(target, *buffer);
+    glBufferData(target, (GLsizeiptr)*capacity, 0, GL_STREAM_DRAW);
+    glBufferSubData(target, 0, (GLsizeiptr)numBytes, data);
+    glBindBuffer(target, 0);
+}
@@ -0,0 +1,138 @@
+/*
+* GlGeomDrawBuilder.h - Version 0.9 - October 18, 2026
+*
+* A GlGeomDrawBuilder gathers draws of GlGeomShape objects, each a range of
+*    instances in an instance buffer (see GlGeomInstances.h), and submits them
+*    with as few API calls as possible.
+*    The draws are sorted by VAO. All the draws with the same VAO (e.g. all
+*    shapes in one pool of a GlGeomArena, or all users of a shared mesh) are
+*    submitted with a single glMultiDrawElementsIndirect, from a buffer of
+*    DrawElementsIndirectCommand's (GlGeomDrawCommand).  The first instance of a
+*    draw is its command's baseInstance, so the instance attributes need no changes.
+*    Shapes in one arena pool, in any mix of resolutions, go out in one call.
+*
+*    Each draw may also have four floats of per-draw data. With indirect drawing,
+*    these are in a shader storage buffer, indexed by gl_DrawID in the shader:
+*        #extension GL_ARB_shader_draw_parameters : require
+*        layout(std430, binding = 0) buffer DrawData { vec4 drawData[]; };
+*        ... drawData[gl_DrawIDARB] ...
+*    The binding point is set by SetDrawDataBinding().
+*
+* Multi-draw indirect needs OpenGL 4.3 (or ARB_multi_draw_indirect and
+*    ARB_base_instance). Otherwise (e.g. OpenGL 3.3) the draws are submitted
+*    with glMultiDrawElementsBaseVertex, or with a loop of
+*    glDrawElementsInstancedBaseVertex if there are instance ranges or per-draw data.
+*    In the loop, the per-draw data is loaded into the uniform vec4 set by SetDrawDataUniform().
+*
+* How to use:
+*     GlGeomDrawBuilder Draws;
+*     ...
+*     Draws.Clear();
+*     Draws.Add(Spheres, 0, numMoons, moonLevel);       // Instances 0 to numMoons-1
+*     Draws.Add(Ring, numMoons, 1);
+*     glUseProgram(instancedShaderProgram);
+*     Draws.Submit(Instances.GetBuffer());
+*
+* An addition to the software accompanying POSSIBLE SECOND EDITION TO the book
+*		3D Computer Graphics: A Mathematical Introduction with OpenGL,
+*		by S. Buss, Cambridge University Press, 2003.
+*   Not part of the book's software, and not written by its author.
+*
+* Software is "as-is" and carries no warranty.  It may be used without
+*   restriction, but if you modify it, please change the filenames to
+*   prevent confusion between different versions.
+* Web page of the book's software: http://math.ucsd.edu/~sbuss/MathCG2
+*/
+
+#pragma once
+#ifndef GLGEOM_DRAW_BUILDER_H
+#define GLGEOM_DRAW_BUILDER_H
+
+#include <vector>
+#include "GlGeomInstances.h"
+
+class GlGeomBase;
+
+// The layout of a DrawElementsIndirectCommand, as read by glMultiDrawElementsIndirect.
+struct GlGeomDrawCommand {
+    unsigned int count;             // Number of elements
+    unsigned int instanceCount;
+    unsigned int firstIndex;        // First element, in the EBO
+    int baseVertex;
+    unsigned int baseInstance;      // First instance, in the instance buffer
+};
+
+class GlGeomDrawBuilder
+{
+public:
+    GlGeomDrawBuilder() {}
+    ~GlGeomDrawBuilder();
+
+    GlGeomDrawBuilder(const GlGeomDrawBuilder&) = delete;
+    GlGeomDrawBuilder& operator=(const GlGeomDrawBuilder&) = delete;
+
+    void Clear();
+
+    // Add(): Draw the GL_TRIANGLES elements of a group of the shape (see GlGeomBase::GetElementGroup,
+    //    e.g. a level of a GlGeomSphereLOD), for instances firstInstance to
+    //    firstInstance+instanceCount-1.  drawData is four floats, or nullptr.
+    //    InitializeAttribLocations() must have been called for the shape.
+    void Add(GlGeomBase& shape, int firstInstance = 0, int instanceCount = 1, int group = 0,
+        const float* drawData = nullptr);
+
+    // Submit(): Render all the draws added since Clear().
+    //    instanceBuffer - the buffer from GlGeomInstanceBuffer, or 0 if no instance attributes are used.
+    //    Returns the number of draw calls made.
+    int Submit(unsigned int instanceBuffer = 0);
+
+    int GetNumDraws() const { return (int)draws.size(); }
+
+    // The shader locations of the instance attributes (default: see GlGeomInstance).
+    void SetInstanceAttribLocations(unsigned int matrix_loc, unsigned int color_loc, unsigned int scale_loc);
+    // Where the per-draw data goes: the shader storage buffer binding point (default 0)
+    //    for indirect drawing, and the uniform location for the fallback (default -1, none).
+    void SetDrawDataBinding(unsigned int binding) { drawDataBinding = binding; }
+    void SetDrawDataUniform(int location) { drawDataUniform = location; }
+
+    // Whether glMultiDrawElementsIndirect is used. It can be disabled, e.g. for testing the fallback.
+    static bool IsIndirectSupported();
+    static void SetIndirectEnabled(bool enabled);
+    bool UsesIndirect() const;
+
+private:
+    struct Draw {
+        unsigned int vao;
+        GlGeomDrawCommand cmd;
+        float data[4];
+    };
+    std::vector<Draw> draws;
+    bool hasDrawData = false;
+
+    std::vector<int> order;                     // The draws, sorted by VAO
+    std::vector<GlGeomDrawCommand> commands;    // In the order of submission
+    std::vector<float> drawDataBuffer;          // Ditto, each batch aligned for the storage buffer
+    std::vector<int> batchStarts;               // Start of each batch in commands[] ...
+    std::vector<int> batchDataOffsets;          // ... and in drawDataBuffer[], in floats
+    std::vector<int> fallbackCounts;            // For glMultiDrawElementsBaseVertex
+    std::vector<const void*> fallbackOffsets;
+    std::vector<int> fallbackBaseVertices;
+
+    unsigned int instanceMatrixLoc = GlGeomInstance::MatrixLoc;
+    unsigned int instanceColorLoc = GlGeomInstance::ColorLoc;
+    unsigned int instanceScaleLoc = GlGeomInstance::ScaleLoc;
+    unsigned int drawDataBinding = 0;
+    int drawDataUniform = -1;
+
+    unsigned int indirectBuffer = 0;        // GL_DRAW_INDIRECT_BUFFER with the commands
+    unsigned int storageBuffer = 0;         // GL_SHADER_STORAGE_BUFFER with the per-draw data
+    long long indirectCapacity = 0;         // In bytes
+    long long storageCapacity = 0;
+
+    void MakeBatches();
+    void SubmitIndirect(int batch, int numInBatch);
+    int SubmitFallback(int batch, int numInBatch, unsigned int instanceBuffer);
+    static void UploadStream(unsigned int target, unsigned int* buffer, long long* capacity,
+        const void* data, long long numBytes);
+};
+
+#endif  // GLGEOM_DRAW_BUILDER_H
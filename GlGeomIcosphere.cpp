@@ -0,0 +1,291 @@
+/*
+* GlGeomIcosphere.cpp - Version 0.9 - October 18, 2026
+*
+* C++ class for rendering icospheres in Modern OpenGL.
+*    See GlGeomIcosphere.h for more information.
+*
+* An addition to the software accompanying POSSIBLE SECOND EDITION TO the book
+*		3D Computer Graphics: A Mathematical Introduction with OpenGL,
+*		by S. Buss, Cambridge University Press, 2003.
+*   Not part of the book's software, and not written by its author.
+*
+* Software is "as-is" and carries no warranty.  It may be used without
+*   restriction, but if you modify it, please change the filenames to
+*   prevent confusion between different versions.
+* Web page of the book's software: http://math.ucsd.edu/~sbuss/MathCG2
+*/
+
+// Use the static library (so glew32.dll is not needed):
+#define GLEW_STATIC
+#include <GL/glew.h>
+#include <GLFW/glfw3.h>
+
+#include "MathMisc.h"
+#include "assert.h"
+#include <stdio.h>
+#include <vector>
+
+#include "GlGeomIcosphere.h"
+#include "GlGeomParallel.h"
+
+namespace {
+    // The icosahedron: the vertices are (0,+-1,+-g), (+-1,+-g,0), (+-g,0,+-1),
+    //    where g is the golden ratio. Faces are counterclockwise from outside.
+    const double G = 1.6180339887498949;
+    const double IcoCorners[12][3] = {
+        { -1, G, 0 }, { 1, G, 0 }, { -1, -G, 0 }, { 1, -G, 0 },
+        { 0, -1, G }, { 0, 1, G }, { 0, -1, -G }, { 0, 1, -G },
+        { G, 0, -1 }, { G, 0, 1 }, { -G, 0, -1 }, { -G, 0, 1 } };
+    const int IcoFaces[20][3] = {
+        { 0, 11, 5 }, { 0, 5, 1 }, { 0, 1, 7 }, { 0, 7, 10 }, { 0, 10, 11 },
+        { 1, 5, 9 }, { 5, 11, 4 }, { 11, 10, 2 }, { 10, 7, 6 }, { 7, 1, 8 },
+        { 3, 9, 4 }, { 3, 4, 2 }, { 3, 2, 6 }, { 3, 6, 8 }, { 3, 8, 9 },
+        { 4, 9, 5 }, { 2, 4, 11 }, { 6, 2, 10 }, { 8, 6, 7 }, { 9, 8, 1 } };
+
+    // The 30 edges, and which face "owns" each edge and each corner.
+    //    The owner is the first face containing it, and is the only face
+    //    that writes the shared vertices (so the faces can be calculated in parallel).
+    struct IcoEdgeTable {
+        int edge[30][2];            // Corners, with edge[e][0] < edge[e][1]
+        int faceEdge[20][3];        // Edges a-b, b-c, a-c of each face
+        int edgeOwner[30];
+        int cornerOwner[12];
+
+        IcoEdgeTable() {
+            int numEdges = 0;
+            for (int i = 0; i < 12; i++) {
+                cornerOwner[i] = -1;
+            }
+            for (int f = 0; f < 20; f++) {
+                const int* c = IcoFaces[f];
+                const int ends[3][2] = { { c[0], c[1] }, { c[1], c[2] }, { c[0], c[2] } };
+                for (int k = 0; k < 3; k++) {
+                    int p = Min(ends[k][0], ends[k][1]);
+                    int q = Max(ends[k][0], ends[k][1]);
+                    int e = 0;
+                    while (e < numEdges && (edge[e][0] != p || edge[e][1] != q)) {
+                        e++;
+                    }
+                    if (e == numEdges) {
+                        edge[e][0] = p;
+                        edge[e][1] = q;
+                        edgeOwner[e] = f;
+                        numEdges++;
+                    }
+                    faceEdge[f][k] = e;
+                    if (cornerOwner[c[k]] < 0) {
+                        cornerOwner[c[k]] = f;
+                    }
+                }
+            }
+            assert(numEdges == 30);
+        }
+    };
+
+    const IcoEdgeTable& EdgeTable() {
+        static const IcoEdgeTable table;
+        return table;
+    }
+
+    // Longitude as the s texture coordinate, in [0,1), as for GlGeomSphere.
+    //    theta measures from the (negative-z)-axis, going counterclockwise viewed from above.
+    double Longitude(double x, double z) {
+        double s = atan2(-x, -z) / PI2;
+        return (s < 0.0) ? s + 1.0 : s;
+    }
+}
+
+GlGeomIcosphere::GlGeomIcosphere(int freq)
+{
+    frequency = ClampRange(freq, 1, 128);
+}
+
+void GlGeomIcosphere::Remesh(int freq)
+{
+    freq = ClampRange(freq, 1, 128);
+    if (freq == frequency) {
+        return;
+    }
+    frequency = freq;
+    SetMeshDirty();
+}
+
+std::string GlGeomIcosphere::GetShapeKey() const
+{
+    char key[40];
+    snprintf(key, sizeof(key), "GlGeomIcosphere %d", frequency);
+    return std::string(key);
+}
+
+// Create the VBO and EBO data for the icosphere.
+// See GlGeomBase.h for more information.
+// Each of the twenty faces is calculated separately, possibly in parallel.
+void GlGeomIcosphere::CalcVboAndEbo(float* VBOdataBuffer, unsigned int* EBOdataBuffer,
+    int vertPosOffset, int vertNormalOffset, int vertTexCoordsOffset, unsigned int stride)
+{
+    assert(vertPosOffset >= 0 && stride > 0);
+    int numVertices = (vertTexCoordsOffset >= 0) ? GetNumVerticesTexCoords() : GetNumVerticesNoTexCoords();
+    EdgeTable();        // Build the table before starting threads
+    GlGeomParallelFor(20, numVertices, [=](int face) {
+        CalcFace(face, VBOdataBuffer, EBOdataBuffer, vertPosOffset, vertNormalOffset, vertTexCoordsOffset, stride);
+    });
+}
+
+// Calculate the vertices and the triangles of one face of the icosahedron.
+//    The vertices of face a,b,c are numbered (i,j) with i,j >= 0 and i+j <= frequency.
+//    Vertex (i,j) is in the direction of (n-i-j)*a + i*b + j*c, where n is the frequency.
+void GlGeomIcosphere::CalcFace(int face, float* VBOdataBuffer, unsigned int* EBOdataBuffer,
+    int vertPosOffset, int vertNormalOffset, int vertTexCoordsOffset, unsigned int stride) const
+{
+    bool calcNormals = (vertNormalOffset >= 0);
+    bool calcTexCoords = (vertTexCoordsOffset >= 0);
+    const int n = frequency;
+    const double* A = IcoCorners[IcoFaces[face][0]];
+    const double* B = IcoCorners[IcoFaces[face][1]];
+    const double* C = IcoCorners[IcoFaces[face][2]];
+
+    // The s coordinates on a face are kept within 1/2 of the s coordinate of the center.
+    double sCenter = Longitude(A[0] + B[0] + C[0], A[2] + B[2] + C[2]);
+
+    std::vector<unsigned int> vertNumbers(GetNumVerticesPerFace());
+    unsigned int* vertNum = vertNumbers.data();
+    for (int j = 0; j <= n; j++) {
+        for (int i = 0; i <= n - j; i++, vertNum++) {
+            if (!GetVertexNumber(face, i, j, calcTexCoords, vertNum)) {
+                continue;       // Calculated by another face
+            }
+            // Integer weights, so that shared vertices are the same from every face.
+            double wa = (double)(n - i - j);
+            double wb = (double)i;
+            double wc = (double)j;
+            double x = wa * A[0] + wb * B[0] + wc * C[0];
+            double y = wa * A[1] + wb * B[1] + wc * C[1];
+            double z = wa * A[2] + wb * B[2] + wc * C[2];
+            double normInv = 1.0 / sqrt(x*x + y * y + z * z);
+            x *= normInv;
+            y *= normInv;
+            z *= normInv;
+            float* basePtr = VBOdataBuffer + stride * (*vertNum);
+            float* vPtr = basePtr + vertPosOffset;
+            *vPtr = (float)x;
+            *(vPtr + 1) = (float)y;
+            *(vPtr + 2) = (float)z;
+            if (calcNormals) {
+                float* nPtr = basePtr + vertNormalOffset;
+                *nPtr = (float)x;
+                *(nPtr + 1) = (float)y;
+                *(nPtr + 2) = (float)z;
+            }
+            if (calcTexCoords) {
+                double s = sCenter;         // At the poles, use the center of the face
+                if (x*x + z * z > 1.0e-12) {
+                    s = Longitude(x, z);
+                    if (s - sCenter > 0.5) {
+                        s -= 1.0;
+                    }
+                    else if (sCenter - s > 0.5) {
+                        s += 1.0;
+                    }
+                }
+                float* tcPtr = basePtr + vertTexCoordsOffset;
+                *tcPtr = (float)s;
+                *(tcPtr + 1) = (float)(acos(ClampRange(-y, -1.0, 1.0)) / PI);
+            }
+        }
+    }
+
+    if (EBOdataBuffer == nullptr) {
+        return;
+    }
+
+    // The triangles: for each (i,j), the triangle (i,j),(i+1,j),(i,j+1),
+    //    and (except at the end of the row) the triangle (i+1,j),(i+1,j+1),(i,j+1).
+    unsigned int* toEbo = EBOdataBuffer + face * GetNumElementsInFace();
+    const unsigned int* row = vertNumbers.data();
+    for (int j = 0; j < n; j++) {
+        const unsigned int* nextRow = row + (n - j + 1);
+        for (int i = 0; i < n - j; i++) {
+            *(toEbo++) = row[i];
+            *(toEbo++) = row[i + 1];
+            *(toEbo++) = nextRow[i];
+            if (i < n - j - 1) {
+                *(toEbo++) = row[i + 1];
+                *(toEbo++) = nextRow[i + 1];
+                *(toEbo++) = nextRow[i];
+            }
+        }
+        row = nextRow;
+    }
+    assert(toEbo - EBOdataBuffer == (face + 1) * GetNumElementsInFace());
+}
+
+// Calculate the vertex number for the vertex (i,j) of a face.
+// With texture coordinates, each face has its own vertices, numbered row by row.
+// Otherwise the vertices are shared: first the 12 corners, then the vertices inside
+//     the 30 edges, then the vertices inside the 20 faces.
+// Returns false if the vertex is calculated by a different face.
+bool GlGeomIcosphere::GetVertexNumber(int face, int i, int j, bool calcTexCoords, unsigned int* retVertNum) const
+{
+    const int n = frequency;
+    if (calcTexCoords) {
+        *retVertNum = face * GetNumVerticesPerFace() + j * (n + 1) - j * (j - 1) / 2 + i;
+        return true;
+    }
+
+    const IcoEdgeTable& table = EdgeTable();
+    const int* c = IcoFaces[face];
+    int corner = -1;
+    int edgeK = -1;             // Which edge of the face: 0 is a-b, 1 is b-c, 2 is a-c
+    int step = 0;               // Number of steps along the edge from its first corner
+    if (j == 0) {
+        if (i == 0) corner = c[0];
+        else if (i == n) corner = c[1];
+        else { edgeK = 0; step = i; }
+    }
+    else if (i == 0) {
+        if (j == n) corner = c[2];
+        else { edgeK = 2; step = j; }
+    }
+    else if (i + j == n) {
+        edgeK = 1;
+        step = j;
+    }
+
+    if (corner >= 0) {
+        *retVertNum = corner;
+        return (table.cornerOwner[corner] == face);
+    }
+    if (edgeK >= 0) {
+        int e = table.faceEdge[face][edgeK];
+        int from = (edgeK == 1) ? c[1] : c[0];
+        if (from != table.edge[e][0]) {
+            step = n - step;    // Count from the lower numbered corner
+        }
+        *retVertNum = 12 + e * (n - 1) + (step - 1);
+        return (table.edgeOwner[e] == face);
+    }
+    // Inside the face: rows j = 1, ..., n-2 with n-1-j vertices each.
+    int numInFace = (n - 1)*(n - 2) / 2;
+    int rowStart = (j - 1)*(n - 1) - (j - 1)*j / 2;
+    *retVertNum = 12 + 30 * (n - 1) + face * numInFace + rowStart + (i - 1);
+    return true;
+}
+
+void GlGeomIcosphere::InitializeAttribLocations(
+    unsigned int pos_loc, unsigned int normal_loc, unsigned int texcoords_loc)
+{
+    GlGeomBase::InitializeAttribLocations(pos_loc, normal_loc, texcoords_loc);
+}
+
+void GlGeomIcosphere::Render()
+{
+    PreRender();
+    GlGeomBase::Render();
+}
+
+void GlGeomIcosphere::RenderFace(int face)
+{
+    assert(face >= 0 && face < 20);
+    PreRender();
+    GlGeomBase::RenderEBO(GL_TRIANGLES, GetNumElementsInFace(), face*GetNumElementsInFace());
+}
@@ -0,0 +1,95 @@
+/*
+* GlGeomIcosphere.h - Version 0.9 - October 18, 2026
+*
+* C++ class for rendering icospheres in Modern OpenGL.
+*   An icosphere is a unit sphere formed by subdividing each face of an
+*   icosahedron into a triangular grid, and pushing the vertices out to the sphere.
+*   Unlike GlGeomSphere, there are no poles: all the triangles are
+*   close to equilateral and close to the same size.  For the same
+*   visual error, this needs far fewer triangles than slices and stacks.
+*
+*   The frequency is the number of pieces each edge of the icosahedron
+*   is divided into. There are 20*frequency*frequency triangles.
+*   The faces are calculated in parallel for large meshes (see GlGeomParallel.h).
+*
+*   Without texture coordinates, all vertices are shared by the triangles around them.
+*   With texture coordinates, each face of the icosahedron has its own vertices,
+*   so that the texture coordinates can wrap around the seam (at s = 0 and s = 1).
+*   The texture coordinates are the same as GlGeomSphere's: s is the longitude, t the latitude.
+*
+* An addition to the software accompanying POSSIBLE SECOND EDITION TO the book
+*		3D Computer Graphics: A Mathematical Introduction with OpenGL,
+*		by S. Buss, Cambridge University Press, 2003.
+*   Not part of the book's software, and not written by its author.
+*
+* Software is "as-is" and carries no warranty.  It may be used without
+*   restriction, but if you modify it, please change the filenames to
+*   prevent confusion between different versions.
+* Web page of the book's software: http://math.ucsd.edu/~sbuss/MathCG2
+*/
+
+#pragma once
+#ifndef GLGEOM_ICOSPHERE_H
+#define GLGEOM_ICOSPHERE_H
+
+#include "GlGeomBase.h"
+
+// GlGeomIcosphere
+// How to use:
+//     * Call the constructor GlGeomIcosphere() or Remesh() to set the frequency.
+//     * Then call InitializeAttribLocations(), exactly as for GlGeomSphere.
+//     * Call Render() to render the sphere.
+
+class GlGeomIcosphere : public GlGeomBase
+{
+public:
+    GlGeomIcosphere() : GlGeomIcosphere(4) {}
+    GlGeomIcosphere(int frequency);
+
+    // Remesh: change the frequency (from 1 to 128).
+    void Remesh(int frequency);
+
+    void InitializeAttribLocations(
+        unsigned int pos_loc, unsigned int normal_loc = UINT_MAX, unsigned int texcoords_loc = UINT_MAX);
+
+    // Render the sphere.  Must call InitializeAttribLocations first.
+    void Render();
+    // Render the triangles from one face of the icosahedron (face = 0,...,19).
+    void RenderFace(int face);
+
+    int GetFrequency() const { return frequency; }
+
+    int GetNumElements() const { return 60 * frequency*frequency; }
+    int GetNumVerticesTexCoords() const { return 20 * GetNumVerticesPerFace(); }
+    int GetNumVerticesNoTexCoords() const { return 10 * frequency*frequency + 2; }
+
+    int GetNumTriangles() const { return 20 * frequency*frequency; }
+    int GetNumElementsInFace() const { return 3 * frequency*frequency; }
+    int GetNumVerticesPerFace() const { return (frequency + 1)*(frequency + 2) / 2; }
+
+    bool NormalsEqualPositions() const { return true; }
+    bool FitsUnitCube() const { return true; }
+
+    std::string GetShapeKey() const;
+
+    // Can be moved (e.g., kept in a std::vector), but not copied.
+    GlGeomIcosphere(GlGeomIcosphere&&) = default;
+    GlGeomIcosphere& operator=(GlGeomIcosphere&&) = default;
+
+private:
+    void CalcVboAndEbo(float* VBOdataBuffer, unsigned int* EBOdataBuffer,
+        int vertPosOffset, int vertNormalOffset, int vertTexCoordsOffset,
+        unsigned int stride);
+    void CalcFace(int face, float* VBOdataBuffer, unsigned int* EBOdataBuffer,
+        int vertPosOffset, int vertNormalOffset, int vertTexCoordsOffset,
+        unsigned int stride) const;
+    bool GetVertexNumber(int face, int i, int j, bool calcTexCoords, unsigned int* retVertNum) const;
+
+    GlGeomIcosphere(const GlGeomIcosphere&) = delete;
+    GlGeomIcosphere& operator=(const GlGeomIcosphere&) = delete;
+
+private:
+    int frequency;      // Number of pieces each icosahedron edge is divided into
+};
+
+#endif  // GLGEOM_ICOSPHERE_H
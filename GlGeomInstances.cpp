@@ -0,0 +1,111 @@
+/*
+* GlGeomInstances.cpp - Version 0.9 - October 18, 2026
+*
+* Per-instance data for instanced rendering.
+*    See GlGeomInstances.h for more information.
+*
+* An addition to the software accompanying POSSIBLE SECOND EDITION TO the book
+*		3D Computer Graphics: A Mathematical Introduction with OpenGL,
+*		by S. Buss, Cambridge University Press, 2003.
+*   Not part of the book's software, and not written by its author.
+*
+* Software is "as-is" and carries no warranty.  It may be used without
+*   restriction, but if you modify it, please change the filenames to
+*   prevent confusion between different versions.
+* Web page of the book's software: http://math.ucsd.edu/~sbuss/MathCG2
+*/
+
+// Use the static library (so glew32.dll is not needed):
+#define GLEW_STATIC
+#include <GL/glew.h>
+#include <GLFW/glfw3.h>
+
+#include "GlGeomInstances.h"
+#include "LinearR4.h"
+#include "assert.h"
+#include <climits>
+#include <stddef.h>
+
+GlGeomInstanceBuffer::~GlGeomInstanceBuffer()
+{
+    if (theBuffer != 0) {
+        glDeleteBuffers(1, &theBuffer);
+    }
+}
+
+void GlGeomInstanceBuffer::Add(const LinearMapR4& modelview, float red, float green, float blue, float scale)
+{
+    instances.emplace_back();
+    GlGeomInstance& inst = instances.back();
+    modelview.DumpByColumns(inst.modelview);
+    inst.color[0] = red;
+    inst.color[1] = green;
+    inst.color[2] = blue;
+    inst.scale = scale;
+}
+
+void GlGeomInstanceBuffer::Upload()
+{
+    if (theBuffer == 0) {
+        glGenBuffers(1, &theBuffer);
+    }
+    long long size = (long long)instances.size() * sizeof(GlGeomInstance);
+    if (size > capacity) {
+        capacity = size + size / 2;
+    }
+    glBindBuffer(GL_ARRAY_BUFFER, theBuffer);
+    glBufferData(GL_ARRAY_BUFFER, (GLsizeiptr)capacity, 0, GL_STREAM_DRAW);     // Orphan the old data
+    if (size > 0) {
+        glBufferSubData(GL_ARRAY_BUFFER, 0, (GLsizeiptr)size, instances.data());
+    }
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+void GlGeomInstanceBuffer::SetAttribPointers(unsigned int buffer, int firstInstance,
+    unsigned int matrix_loc, unsigned int color_loc, unsigned int scale_loc)
+{
+    assert(buffer != 0 && "GlGeomInstanceBuffer::Upload must be called before rendering!");
+    const GLsizei stride = sizeof(GlGeomInstance);
+    size_t base = (size_t)firstInstance * sizeof(GlGeomInstance);
+    glBindBuffer(GL_ARRAY_BUFFER, buffer);
+    if (matrix_loc != UINT_MAX) {
+        for (unsigned int i = 0; i < 4; i++) {
+            glVertexAttribPointer(matrix_loc + i, 4, GL_FLOAT, GL_FALSE, stride,
+                (void*)(base + offsetof(GlGeomInstance, modelview) + 4 * i * sizeof(float)));
+            glVertexAttribDivisor(matrix_loc + i, 1);
+            glEnableVertexAttribArray(matrix_loc + i);
+        }
+    }
+    if (color_loc != UINT_MAX) {
+        glVertexAttribPointer(color_loc, 3, GL_FLOAT, GL_FALSE, stride,
+            (void*)(base + offsetof(GlGeomInstance, color)));
+        glVertexAttribDivisor(color_loc, 1);
+        glEnableVertexAttribArray(color_loc);
+    }
+    if (scale_loc != UINT_MAX) {
+        glVertexAttribPointer(scale_loc, 1, GL_FLOAT, GL_FALSE, stride,
+            (void*)(base + offsetof(GlGeomInstance, scale)));
+        glVertexAttribDivisor(scale_loc, 1);
+        glEnableVertexAttribArray(scale_loc);
+    }
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+// The divisors are reset too, so that the locations can be used for per-vertex data again.
+void GlGeomInstanceBuffer::DisableAttribs(unsigned int matrix_loc, unsigned int color_loc, unsigned int scale_loc)
+{
+    if (matrix_loc != UINT_MAX) {
+        for (unsigned int i = 0; i < 4; i++) {
+            glDisableVertexAttribArray(matrix_loc + i);
+            glVertexAttribDivisor(matrix_loc + i, 0);
+        }
+    }
+    if (color_loc != UINT_MAX) {
+        glDisableVertexAttribArray(color_loc);
+        glVertexAttribDivisor(color_loc, 0);
+    }
+    if (scale_loc != UINT_MAX) {
+        glDisableVertexAttribArray(scale_loc);
+        glVertexAttribDivisor(scale_loc, 0);
+    }
+}
@@ -0,0 +1,98 @@
+/*
+* GlGeomInstances.h - Version 0.9 - October 18, 2026
+*
+* A GlGeomInstanceBuffer holds per-instance data (a modelview matrix, a color
+*    and a scale) in a buffer object, for rendering many copies of a shape
+*    with one draw call by GlGeomBase::RenderInstanced().
+*    The instance attributes are read with glVertexAttribDivisor(loc, 1):
+*    once per instance instead of once per vertex.
+*
+* How to use:
+*     GlGeomInstanceBuffer Moons;
+*     ...
+*     Moons.Clear();
+*     for (...) {
+*         Moons.Add(moonModelview, 0.9f, 0.9f, 0.9f);
+*     }
+*     Moons.Upload();
+*     glUseProgram(instancedShaderProgram);     // See ShaderMgrSLR.cpp
+*     Sphere.RenderInstanced(Moons.GetNumInstances(), Moons.GetBuffer());
+*
+* The shader must have the instance attributes at the locations
+*    GlGeomInstance::MatrixLoc (a mat4, using four locations),
+*    GlGeomInstance::ColorLoc and GlGeomInstance::ScaleLoc,
+*    or at the locations set with GlGeomBase::SetInstanceAttribLocations().
+*
+* An addition to the software accompanying POSSIBLE SECOND EDITION TO the book
+*		3D Computer Graphics: A Mathematical Introduction with OpenGL,
+*		by S. Buss, Cambridge University Press, 2003.
+*   Not part of the book's software, and not written by its author.
+*
+* Software is "as-is" and carries no warranty.  It may be used without
+*   restriction, but if you modify it, please change the filenames to
+*   prevent confusion between different versions.
+* Web page of the book's software: http://math.ucsd.edu/~sbuss/MathCG2
+*/
+
+#pragma once
+#ifndef GLGEOM_INSTANCES_H
+#define GLGEOM_INSTANCES_H
+
+#include <vector>
+
+class LinearMapR4;
+
+// The data for one instance, as stored in the instance buffer.
+//    scale multiplies the vertex positions before the modelview matrix;
+//    shaders may use it for something else, e.g. a level of detail.
+struct GlGeomInstance {
+    float modelview[16];        // By columns, as for glUniformMatrix4fv
+    float color[3];
+    float scale;
+
+    // Default attribute locations (used by the instanced shader in ShaderMgrSLR.cpp).
+    //    The matrix uses locations MatrixLoc to MatrixLoc+3, one for each column.
+    static const unsigned int MatrixLoc = 4;
+    static const unsigned int ColorLoc = 8;
+    static const unsigned int ScaleLoc = 9;
+};
+
+class GlGeomInstanceBuffer
+{
+public:
+    GlGeomInstanceBuffer() {}
+    ~GlGeomInstanceBuffer();
+
+    GlGeomInstanceBuffer(const GlGeomInstanceBuffer&) = delete;
+    GlGeomInstanceBuffer& operator=(const GlGeomInstanceBuffer&) = delete;
+
+    void Clear() { instances.clear(); }
+    void Add(const LinearMapR4& modelview, float red, float green, float blue, float scale = 1.0f);
+    void Add(const GlGeomInstance& instance) { instances.push_back(instance); }
+
+    // Upload(): Copy the instances into the buffer object.  Call after the
+    //    instances are added, and before rendering with them.
+    //    The buffer is orphaned each time, so the GPU never has to finish with
+    //    the previous frame's data first.  It only grows.
+    void Upload();
+
+    unsigned int GetBuffer() const { return theBuffer; }
+    int GetNumInstances() const { return (int)instances.size(); }
+    GlGeomInstance& GetInstance(int i) { return instances[i]; }
+    const GlGeomInstance& GetInstance(int i) const { return instances[i]; }
+
+    // Set the instance attribute pointers (with divisor 1) for the bound VAO,
+    //    starting at instance firstInstance of the buffer.
+    //    Locations equal to UINT_MAX are skipped.
+    static void SetAttribPointers(unsigned int buffer, int firstInstance,
+        unsigned int matrix_loc, unsigned int color_loc, unsigned int scale_loc);
+    // Disable the instance attributes again (for the bound VAO).
+    static void DisableAttribs(unsigned int matrix_loc, unsigned int color_loc, unsigned int scale_loc);
+
+private:
+    std::vector<GlGeomInstance> instances;
+    unsigned int theBuffer = 0;
+    long long capacity = 0;             // Allocated size of the buffer in bytes
+};
+
+#endif  // GLGEOM_INSTANCES_H
@@ -0,0 +1,76 @@
+/*
+* GlGeomLOD.cpp - Version 0.9 - October 18, 2026
+*
+* Helpers for choosing a level of detail (LOD) for GlGeomShape objects.
+*    See GlGeomLOD.h for more information.
+*
+* An addition to the software accompanying POSSIBLE SECOND EDITION TO the book
+*		3D Computer Graphics: A Mathematical Introduction with OpenGL,
+*		by S. Buss, Cambridge University Press, 2003.
+*   Not part of the book's software, and not written by its author.
+*
+* Software is "as-is" and carries no warranty.  It may be used without
+*   restriction, but if you modify it, please change the filenames to
+*   prevent confusion between different versions.
+* Web page of the book's software: http://math.ucsd.edu/~sbuss/MathCG2
+*/
+
+#include "GlGeomLOD.h"
+#include "LinearR4.h"
+#include "MathMisc.h"
+#include "assert.h"
+
+double GlGeomProjectedRadius(const LinearMapR4& modelview, const LinearMapR4& projection,
+    int viewportHeight, double radius)
+{
+    // Radius in eye coordinates: scale by the longest of the three axis vectors.
+    double sx = modelview.m11*modelview.m11 + modelview.m21*modelview.m21 + modelview.m31*modelview.m31;
+    double sy = modelview.m12*modelview.m12 + modelview.m22*modelview.m22 + modelview.m32*modelview.m32;
+    double sz = modelview.m13*modelview.m13 + modelview.m23*modelview.m23 + modelview.m33*modelview.m33;
+    double r = radius * sqrt(Max(sx, Max(sy, sz)));
+
+    // projection.m22 is 2*near/(top-bottom) for Set_glFrustum, or 2/(top-bottom) for Set_glOrtho.
+    double halfHeight = 0.5*(double)viewportHeight;
+    if (projection.m43 == 0.0) {
+        return r * projection.m22 * halfHeight;     // Orthographic
+    }
+
+    // Perspective: the sphere subtends the angle asin(r/dist) from the eye.
+    double distSq = modelview.m14*modelview.m14 + modelview.m24*modelview.m24 + modelview.m34*modelview.m34;
+    double dSq = distSq - r*r;
+    if (dSq <= 0.0) {
+        return DBL_MAX;         // Eye is inside the sphere
+    }
+    return r * projection.m22 * halfHeight / sqrt(dSq);
+}
+
+double GlGeomChordSegments(double pixelRadius, double maxError)
+{
+    assert(maxError > 0.0);
+    if (pixelRadius <= maxError) {
+        return 0.0;
+    }
+    double halfAngle = acos(1.0 - maxError / pixelRadius);
+    return (halfAngle > 0.0) ? PI / halfAngle : DBL_MAX;
+}
+
+int GlGeomSelectLevel(const int* levelDetail, int numLevels, double neededDetail,
+    GlGeomLodState* state, double hysteresis)
+{
+    assert(numLevels > 0);
+    int level = 0;
+    while (level < numLevels - 1 && levelDetail[level] < neededDetail) {
+        level++;
+    }
+    if (state != nullptr) {
+        int current = state->level;
+        if (current >= 0 && current < numLevels) {
+            // Only move to a coarser level when clearly below its detail.
+            while (level < current && neededDetail > (1.0 - hysteresis)*levelDetail[level]) {
+                level++;
+            }
+        }
+        state->level = level;
+    }
+    return level;
+}
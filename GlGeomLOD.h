@@ -0,0 +1,63 @@
+/*
+* GlGeomLOD.h - Version 0.9 - October 18, 2026
+*
+* Helpers for choosing a level of detail (LOD) for GlGeomShape objects
+*    which hold several mesh resolutions, such as GlGeomSphereLOD.
+*
+*    GlGeomProjectedRadius() estimates the radius in pixels of a bounding
+*       sphere, from the modelview matrix (as loaded into the shader) and
+*       a projection matrix from Set_glFrustum() (or Set_glOrtho()).
+*    GlGeomChordSegments() gives the number of segments needed for a circle
+*       on the screen, so that no chord is more than a given error from the circle.
+*    GlGeomSelectLevel() picks the coarsest level with enough detail.
+*       A GlGeomLodState remembers the level chosen for an object, so that
+*       a coarser level is only chosen once the object is clearly smaller.
+*       This hysteresis avoids popping back and forth between two levels.
+*       Use a separate GlGeomLodState for each object rendered, even when
+*       several objects are rendered with the same GlGeomShape.
+*
+* An addition to the software accompanying POSSIBLE SECOND EDITION TO the book
+*		3D Computer Graphics: A Mathematical Introduction with OpenGL,
+*		by S. Buss, Cambridge University Press, 2003.
+*   Not part of the book's software, and not written by its author.
+*
+* Software is "as-is" and carries no warranty.  It may be used without
+*   restriction, but if you modify it, please change the filenames to
+*   prevent confusion between different versions.
+* Web page of the book's software: http://math.ucsd.edu/~sbuss/MathCG2
+*/
+
+#pragma once
+#ifndef GLGEOM_LOD_H
+#define GLGEOM_LOD_H
+
+class LinearMapR4;
+
+// The level last chosen for one rendered object. -1 means none yet.
+struct GlGeomLodState {
+    int level = -1;
+};
+
+// Radius in pixels of a sphere of the given radius, centered at the origin of
+//    the model coordinates. The largest scale factor in the modelview matrix is used.
+//    viewportHeight is the height of the viewport in pixels.
+//    Returns a very large value if the camera is inside the sphere.
+double GlGeomProjectedRadius(const LinearMapR4& modelview, const LinearMapR4& projection,
+    int viewportHeight, double radius = 1.0);
+
+// Number of segments needed so that a circle with the given radius in pixels
+//    is approximated by chords within maxError pixels of the circle.
+//    A chord of angle 2*pi/n is R*(1-cos(pi/n)) from the circle, so n = pi/acos(1-maxError/R).
+//    Returns 0 if the circle is within maxError of its center (any number of segments will do).
+double GlGeomChordSegments(double pixelRadius, double maxError);
+
+// Select a level of detail.
+//    levelDetail[] - the detail of each level, in increasing order (e.g., the number of slices)
+//    neededDetail - the detail needed for the current size on the screen.
+//    Returns the first level with levelDetail[i] >= neededDetail (or the last level).
+//    If state is not null, it is updated. A level coarser than state->level
+//       is only returned if neededDetail <= (1-hysteresis)*levelDetail[i].
+int GlGeomSelectLevel(const int* levelDetail, int numLevels, double neededDetail,
+    GlGeomLodState* state = nullptr, double hysteresis = 0.25);
+
+#endif  // GLGEOM_LOD_H
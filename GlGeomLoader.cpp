@@ -0,0 +1,215 @@
+/*
+* GlGeomLoader.cpp - Version 0.9 - October 18, 2026
+*
+* Calculates and uploads shape meshes on a thread with a shared OpenGL context.
+*    See GlGeomLoader.h for more information.
+*
+* An addition to the software accompanying POSSIBLE SECOND EDITION TO the book
+*		3D Computer Graphics: A Mathematical Introduction with OpenGL,
+*		by S. Buss, Cambridge University Press, 2003.
+*   Not part of the book's software, and not written by its author.
+*
+* Software is "as-is" and carries no warranty.  It may be used without
+*   restriction, but if you modify it, please change the filenames to
+*   prevent confusion between different versions.
+* Web page of the book's software: http://math.ucsd.edu/~sbuss/MathCG2
+*/
+
+// Use the static library (so glew32.dll is not needed):
+#define GLEW_STATIC
+#include <GL/glew.h>
+#include <GLFW/glfw3.h>
+
+#include "GlGeomLoader.h"
+#include "GlGeomBase.h"
+#include "assert.h"
+#include <utility>
+
+// The hidden window gets the same context version and profile as the main
+//    window, since the window hints set for the main window still apply.
+GlGeomLoader::GlGeomLoader(GLFWwindow* mainWindow)
+{
+    glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+    loaderWindow = glfwCreateWindow(1, 1, "GlGeomLoader", NULL, mainWindow);
+    glfwWindowHint(GLFW_VISIBLE, GLFW_TRUE);
+    assert(loaderWindow != nullptr && "Failed to create the loader's OpenGL context!");
+    loaderThread = std::thread([this]() { Run(); });
+}
+
+GlGeomLoader::~GlGeomLoader()
+{
+    WaitAll();
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    jobAdded.notify_all();
+    loaderThread.join();
+    glfwDestroyWindow(loaderWindow);
+}
+
+void GlGeomLoader::Load(GlGeomBase& shape, unsigned int pos_loc, unsigned int normal_loc, unsigned int texcoords_loc)
+{
+    Enqueue(shape, pos_loc, normal_loc, texcoords_loc, nullptr);
+}
+
+void GlGeomLoader::Enqueue(GlGeomBase& shape, unsigned int pos_loc, unsigned int normal_loc, unsigned int texcoords_loc,
+    std::function<void()> finish)
+{
+    shape.BeginAsyncLoad(pos_loc, normal_loc, texcoords_loc);
+    Job job = {};
+    job.shape = &shape;
+    job.finish = std::move(finish);
+    job.numVertices = shape.UseTexCoords() ? shape.GetNumVerticesTexCoords() : shape.GetNumVerticesNoTexCoords();
+    job.vboBytes = (long long)job.numVertices * shape.GetVertexLayout().stride;
+    job.eboBytes = (long long)shape.GetNumEboElements() * sizeof(unsigned int);
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        queue.push_back(job);
+    }
+    jobAdded.notify_one();
+    numPending++;
+}
+
+// The spare gets the shape's vertex format and attribute locations, so that the
+//    two have the same mesh key when the spare has loaded.
+void GlGeomLoader::StartRemesh(GlGeomBase& shape, GlGeomBase& spare, std::function<void()> finish)
+{
+    assert((shape.theVAO != 0 || shape.evicted) && "InitializeAttribLocations must be called before re-meshing!");
+    assert(shape.theArena == nullptr && "Shapes in an arena cannot be loaded by a GlGeomLoader!");
+    assert(!shape.loadPending && !shape.remeshPending && "The shape is already being loaded!");
+    shape.remeshPending = true;
+    spare.SetVertexFormat(shape.GetVertexFormat());
+    Enqueue(spare, shape.posLoc, shape.normalLoc, shape.texcoordsLoc, std::move(finish));
+}
+
+// Called after the shape has been re-meshed on the render thread. A shared shape
+//    leaves its shared mesh, and owns the new buffers.
+void GlGeomLoader::FinishRemesh(GlGeomBase& shape, GlGeomBase& spare)
+{
+    shape.remeshPending = false;
+    std::string meshKey = shape.GetMeshKey();
+    if (!meshKey.empty() && meshKey == spare.GetMeshKey() && shape.theArena == nullptr) {
+        shape.AdoptBuffers(spare);
+    }
+}
+
+// The loader thread: upload the jobs one at a time, in the order loaded.
+void GlGeomLoader::Run()
+{
+    glfwMakeContextCurrent(loaderWindow);
+    while (true) {
+        Job job;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            jobAdded.wait(lock, [this]() { return stopping || !queue.empty(); });
+            if (stopping) {
+                break;
+            }
+            job = queue.front();
+            queue.pop_front();
+        }
+        Upload(job);
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            uploaded.push_back(job);
+        }
+        jobDone.notify_all();
+    }
+    glfwMakeContextCurrent(NULL);
+}
+
+// Runs on the loader thread. Only the copy targets are bound, in the loader's own context.
+//    The flush sends the commands and the fence to the GPU, so the render thread's
+//    glClientWaitSync will see the fence signal.
+void GlGeomLoader::Upload(Job& job)
+{
+    glGenBuffers(1, &job.vbo);
+    glGenBuffers(1, &job.ebo);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, job.vbo);
+    glBufferData(GL_COPY_WRITE_BUFFER, (GLsizeiptr)job.vboBytes, 0, GL_STATIC_DRAW);
+    void* VBOdata = glMapBufferRange(GL_COPY_WRITE_BUFFER, 0, (GLsizeiptr)job.vboBytes,
+        GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT);
+    glBindBuffer(GL_COPY_READ_BUFFER, job.ebo);
+    glBufferData(GL_COPY_READ_BUFFER, (GLsizeiptr)job.eboBytes, 0, GL_STATIC_DRAW);
+    unsigned int* EBOdata = (unsigned int*)glMapBufferRange(GL_COPY_READ_BUFFER, 0, (GLsizeiptr)job.eboBytes,
+        GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT);
+
+    bool mapped = (VBOdata != nullptr && EBOdata != nullptr);
+    if (mapped) {
+        job.shape->FillVboAndEbo(VBOdata, EBOdata, job.numVertices, nullptr, false);
+    }
+    // glUnmapBuffer returns false if the contents were lost while mapped.
+    if (VBOdata != nullptr) {
+        mapped = (glUnmapBuffer(GL_COPY_WRITE_BUFFER) == GL_TRUE) && mapped;
+    }
+    if (EBOdata != nullptr) {
+        mapped = (glUnmapBuffer(GL_COPY_READ_BUFFER) == GL_TRUE) && mapped;
+    }
+    if (!mapped) {
+        // Fill copies in memory instead, and upload them with glBufferSubData.
+        std::vector<unsigned char> vboCopy((size_t)job.vboBytes);
+        std::vector<unsigned int> eboCopy((size_t)(job.eboBytes / sizeof(unsigned int)));
+        job.shape->FillVboAndEbo(vboCopy.data(), eboCopy.data(), job.numVertices, nullptr, false);
+        glBufferSubData(GL_COPY_WRITE_BUFFER, 0, (GLsizeiptr)job.vboBytes, vboCopy.data());
+        glBufferSubData(GL_COPY_READ_BUFFER, 0, (GLsizeiptr)job.eboBytes, eboCopy.data());
+    }
+    glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+    glBindBuffer(GL_COPY_READ_BUFFER, 0);
+    job.sync = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    glFlush();
+}
+
+int GlGeomLoader::Poll()
+{
+    return FinishUploaded(false);
+}
+
+void GlGeomLoader::WaitAll()
+{
+    while (numPending > 0) {
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            jobDone.wait(lock, [this]() { return !uploaded.empty(); });
+        }
+        FinishUploaded(true);
+    }
+}
+
+// Finish the uploaded jobs whose fences have signaled (or all of them, if wait is true).
+//    The others are kept for the next call.
+int GlGeomLoader::FinishUploaded(bool wait)
+{
+    std::vector<Job> jobs;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        jobs.swap(uploaded);
+    }
+    int numFinished = 0;
+    std::vector<Job> notReady;
+    for (size_t i = 0; i < jobs.size(); i++) {
+        Job& job = jobs[i];
+        GLsync sync = (GLsync)job.sync;
+        GLenum result = glClientWaitSync(sync, 0, 0);
+        while (wait && result == GL_TIMEOUT_EXPIRED) {
+            result = glClientWaitSync(sync, 0, 1000000);    // Up to one millisecond
+        }
+        if (result == GL_TIMEOUT_EXPIRED) {
+            notReady.push_back(job);
+            continue;
+        }
+        assert(result != GL_WAIT_FAILED);
+        glDeleteSync(sync);
+        job.shape->FinishAsyncLoad(job.vbo, job.ebo, job.vboBytes, job.eboBytes);
+        if (job.finish) {
+            job.finish();
+        }
+        numPending--;
+        numFinished++;
+    }
+    if (!notReady.empty()) {
+        std::lock_guard<std::mutex> lock(mutex);
+        uploaded.insert(uploaded.begin(), notReady.begin(), notReady.end());
+    }
+    return numFinished;
+}
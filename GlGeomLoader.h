@@ -0,0 +1,137 @@
+/*
+* GlGeomLoader.h - Version 0.9 - October 18, 2026
+*
+* A GlGeomLoader calculates and uploads the meshes of GlGeomShape objects on
+*    a background thread, so that re-meshing a large shape does not stall rendering.
+*    The thread has its own OpenGL context, in a hidden window, sharing objects
+*    with the main window's context.  For each shape, it creates a VBO and EBO,
+*    maps them, fills them via CalcVboAndEbo() (or the shape's compile time mesh),
+*    and places a fence with glFenceSync.  The render thread calls Poll() once
+*    per frame: a shape whose fence has signaled gets a new VAO for the
+*    buffers (VAOs are not shared between contexts), and can then be rendered.
+*    Poll() never waits for the GPU.
+*
+* Load() is for a shape which is not yet on screen (for instance, at startup).
+*    A shape being loaded cannot be rendered (see GlGeomBase::IsLoading()),
+*    and must not be changed, rendered or deleted until it has loaded.
+*
+* Remesh() re-meshes a shape which is being rendered.  The new mesh is loaded
+*    into a spare object of the same class, and the shape keeps rendering its
+*    old VAO, VBO and EBO until the new ones are ready.  Then Poll() re-meshes
+*    the shape itself, and the shape takes over the spare's buffers:
+*        Loader.Remesh(Spheres, [](GlGeomSphereLOD& s) { s.Remesh(5, 6, 4); });
+*        ...
+*        Loader.Poll();                      // Every frame
+*    The function is called for the spare (a default constructed object) and
+*    later for the shape, so must set every parameter of the mesh. If the two
+*    meshes then differ (their mesh keys are not equal, or empty), the new buffers
+*    are dropped, and the shape calculates its mesh as usual when next rendered.
+*
+* Loaded meshes are not shared (GlGeomRegistry.h) or placed in an arena
+*    (GlGeomArena.h), and the mesh cache (GlGeomMeshCache.h) is not used,
+*    since these are only used from the render thread.  Re-meshing a shape
+*    in some other way is done as usual, on the render thread.
+*
+* The loader must be created and deleted on the main thread, with the main window's
+*    context current, and deleted before that window.  The destructor waits for all loads.
+*
+* An addition to the software accompanying POSSIBLE SECOND EDITION TO the book
+*		3D Computer Graphics: A Mathematical Introduction with OpenGL,
+*		by S. Buss, Cambridge University Press, 2003.
+*   Not part of the book's software, and not written by its author.
+*
+* Software is "as-is" and carries no warranty.  It may be used without
+*   restriction, but if you modify it, please change the filenames to
+*   prevent confusion between different versions.
+* Web page of the book's software: http://math.ucsd.edu/~sbuss/MathCG2
+*/
+
+#pragma once
+#ifndef GLGEOM_LOADER_H
+#define GLGEOM_LOADER_H
+
+#include <climits>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class GlGeomBase;
+struct GLFWwindow;
+
+class GlGeomLoader
+{
+public:
+    // mainWindow - the window whose context the loader's context shares objects with.
+    GlGeomLoader(GLFWwindow* mainWindow);
+    ~GlGeomLoader();
+
+    GlGeomLoader(const GlGeomLoader&) = delete;
+    GlGeomLoader& operator=(const GlGeomLoader&) = delete;
+
+    // Load(): Start loading the shape's current mesh, with the given attribute locations
+    //    (as for InitializeAttribLocations).  The shape's current buffers are released now.
+    void Load(GlGeomBase& shape,
+        unsigned int pos_loc, unsigned int normal_loc = UINT_MAX, unsigned int texcoords_loc = UINT_MAX);
+
+    // Remesh(): Re-meshes the shape (see above) with remesh(shape), on the loader's thread.
+    //    The shape must have been initialized, and not be in an arena or already re-meshing.
+    template<class Shape, class RemeshFn>
+    void Remesh(Shape& shape, RemeshFn remesh);
+
+    // Poll(): Finish the loads whose uploads have completed on the GPU.
+    //    Call once per frame from the render thread.  Returns the number of shapes finished.
+    int Poll();
+    // WaitAll(): Wait until every load has finished.
+    void WaitAll();
+
+    int GetNumPending() const { return numPending; }
+
+private:
+    struct Job {
+        GlGeomBase* shape;
+        int numVertices;
+        long long vboBytes;
+        long long eboBytes;
+        unsigned int vbo;
+        unsigned int ebo;
+        void* sync;             // The GLsync placed after the upload
+        std::function<void()> finish;   // Called after the load is finished (for Remesh())
+    };
+
+    GLFWwindow* loaderWindow = nullptr;     // Hidden window with the loader's context
+    std::thread loaderThread;
+    std::mutex mutex;                       // Guards the three members below
+    std::condition_variable jobAdded;
+    std::condition_variable jobDone;
+    std::deque<Job> queue;                  // Loads not yet started
+    std::vector<Job> uploaded;              // Loads uploaded by the loader thread
+    bool stopping = false;
+    int numPending = 0;                     // Loads not yet finished (render thread only)
+
+    void Enqueue(GlGeomBase& shape, unsigned int pos_loc, unsigned int normal_loc, unsigned int texcoords_loc,
+        std::function<void()> finish);
+    void StartRemesh(GlGeomBase& shape, GlGeomBase& spare, std::function<void()> finish);
+    static void FinishRemesh(GlGeomBase& shape, GlGeomBase& spare);
+    void Run();
+    static void Upload(Job& job);
+    int FinishUploaded(bool wait);
+};
+
+// The spare is deleted as a Shape (GlGeomBase has no virtual destructor), on the render thread.
+template<class Shape, class RemeshFn>
+void GlGeomLoader::Remesh(Shape& shape, RemeshFn remesh)
+{
+    Shape* spare = new Shape();
+    remesh(*spare);
+    StartRemesh(shape, *spare, [&shape, spare, remesh]() mutable {
+        std::unique_ptr<Shape> owned(spare);
+        remesh(shape);
+        FinishRemesh(shape, *owned);
+    });
+}
+
+#endif  // GLGEOM_LOADER_H
@@ -0,0 +1,39 @@
+/*
+* GlGeomMesh.cpp - Version 0.9 - October 18, 2026
+*
+* CPU side container for GlGeomShape meshes.
+*    See GlGeomMesh.h for more information.
+*
+* An addition to the software accompanying POSSIBLE SECOND EDITION TO the book
+*		3D Computer Graphics: A Mathematical Introduction with OpenGL,
+*		by S. Buss, Cambridge University Press, 2003.
+*   Not part of the book's software, and not written by its author.
+*
+* Software is "as-is" and carries no warranty.  It may be used without
+*   restriction, but if you modify it, please change the filenames to
+*   prevent confusion between different versions.
+* Web page of the book's software: http://math.ucsd.edu/~sbuss/MathCG2
+*/
+
+#include "GlGeomMesh.h"
+#include <stddef.h>
+
+void GlGeomMesh::SetLayout(bool normals, bool texCoords)
+{
+    vertPosOffset = 0;
+    vertNormalOffset = normals ? 3 : -1;
+    vertTexCoordsOffset = texCoords ? (normals ? 6 : 3) : -1;
+    stride = 3 + (normals ? 3 : 0) + (texCoords ? 2 : 0);
+}
+
+void GlGeomMesh::Resize(int numVertices, int numElements)
+{
+    vertices.resize((size_t)numVertices * stride);
+    elements.resize((size_t)numElements);
+}
+
+void GlGeomMesh::Clear()
+{
+    vertices.clear();
+    elements.clear();
+}
@@ -0,0 +1,65 @@
+/*
+* GlGeomMesh.h - Version 0.9 - October 18, 2026
+*
+* A GlGeomMesh holds the vertex data and elements of a GlGeomShape in
+*    ordinary (CPU) memory.  It does not use OpenGL, so meshes can be
+*    generated, cached and tested without an OpenGL context, for instance
+*    on a worker thread, and loaded into the VBO and EBO later.
+*    GlGeomBase::GenerateMesh() is in GlGeomBaseMesh.cpp, which does not include
+*    GLEW or GLFW either.
+*
+* How to use:
+*     GlGeomSphere sphere(20, 20);
+*     GlGeomMesh mesh;
+*     sphere.GenerateMesh(mesh, true, true);      // Positions, normals and texture coordinates
+*     ...
+*     sphere.InitializeAttribLocations(pos_loc, normal_loc, texcoords_loc);
+*     sphere.LoadMesh(mesh);      // Upload the mesh (instead of calculating it again)
+*
+* An addition to the software accompanying POSSIBLE SECOND EDITION TO the book
+*		3D Computer Graphics: A Mathematical Introduction with OpenGL,
+*		by S. Buss, Cambridge University Press, 2003.
+*   Not part of the book's software, and not written by its author.
+*
+* Software is "as-is" and carries no warranty.  It may be used without
+*   restriction, but if you modify it, please change the filenames to
+*   prevent confusion between different versions.
+* Web page of the book's software: http://math.ucsd.edu/~sbuss/MathCG2
+*/
+
+#pragma once
+#ifndef GLGEOM_MESH_H
+#define GLGEOM_MESH_H
+
+#include <vector>
+
+class GlGeomMesh
+{
+public:
+    // Layout of the vertex data, exactly as for GlGeomBase::CalcVboAndEbo:
+    //    Offsets and stride are in floats. Offset -1 means the value is omitted.
+    int vertPosOffset = 0;
+    int vertNormalOffset = -1;
+    int vertTexCoordsOffset = -1;
+    int stride = 3;
+
+    std::vector<float> vertices;            // stride floats per vertex
+    std::vector<unsigned int> elements;     // Vertex indices for GL_TRIANGLES (plus any extra index ranges)
+
+    // Set a tightly packed layout: positions, then normals, then texture coordinates.
+    void SetLayout(bool normals, bool texCoords);
+    // Allocate space for the vertices and elements.
+    void Resize(int numVertices, int numElements);
+    void Clear();
+
+    bool HasNormals() const { return vertNormalOffset >= 0; }
+    bool HasTexCoords() const { return vertTexCoordsOffset >= 0; }
+    int GetNumVertices() const { return (int)vertices.size() / stride; }
+    int GetNumElements() const { return (int)elements.size(); }
+
+    const float* GetPosition(int i) const { return vertices.data() + i * stride + vertPosOffset; }
+    const float* GetNormal(int i) const { return vertices.data() + i * stride + vertNormalOffset; }
+    const float* GetTexCoords(int i) const { return vertices.data() + i * stride + vertTexCoordsOffset; }
+};
+
+#endif  // GLGEOM_MESH_H
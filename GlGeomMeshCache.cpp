@@ -0,0 +1,308 @@
+/*
+* GlGeomMeshCache.cpp - Version 0.9 - October 18, 2026
+*
+* A binary file cache of the VBO and EBO data of GlGeomShape meshes.
+*    See GlGeomMeshCache.h for more information.
+*
+* An addition to the software accompanying POSSIBLE SECOND EDITION TO the book
+*		3D Computer Graphics: A Mathematical Introduction with OpenGL,
+*		by S. Buss, Cambridge University Press, 2003.
+*   Not part of the book's software, and not written by its author.
+*
+* Software is "as-is" and carries no warranty.  It may be used without
+*   restriction, but if you modify it, please change the filenames to
+*   prevent confusion between different versions.
+* Web page of the book's software: http://math.ucsd.edu/~sbuss/MathCG2
+*/
+
+#include "GlGeomMeshCache.h"
+#include "assert.h"
+#include <stdio.h>
+#include <string.h>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// File format (all values little endian, as written by the program):
+//    Header: "GLGEOMMC", file version, mesh version, number of meshes, 0 (each 4 bytes), file size (8 bytes)
+//    Then for each mesh:
+//       key length (4 bytes), 0 (4 bytes), vbo bytes, ebo bytes, checksum (8 bytes each),
+//       the key, then the VBO data followed by the EBO data.
+//       The key and the data are each padded to a multiple of 8 bytes.
+
+namespace {
+    GlGeomMeshCache* DefaultCache = nullptr;
+
+    const char Magic[8] = { 'G', 'L', 'G', 'E', 'O', 'M', 'M', 'C' };
+    const long long HeaderSize = 32;
+    const long long RecordHeaderSize = 32;
+
+    long long PadTo8(long long n) {
+        return (n + 7) & ~7LL;
+    }
+
+    // FNV-1a 64 bit hash
+    unsigned long long Checksum(const unsigned char* data, long long numBytes) {
+        unsigned long long hash = 14695981039346656037ULL;
+        for (long long i = 0; i < numBytes; i++) {
+            hash ^= data[i];
+            hash *= 1099511628211ULL;
+        }
+        return hash;
+    }
+
+    unsigned int ReadU32(const unsigned char* p) {
+        unsigned int v;
+        memcpy(&v, p, 4);
+        return v;
+    }
+    unsigned long long ReadU64(const unsigned char* p) {
+        unsigned long long v;
+        memcpy(&v, p, 8);
+        return v;
+    }
+    void AppendU32(std::vector<unsigned char>& buf, unsigned int v) {
+        const unsigned char* p = (const unsigned char*)&v;
+        buf.insert(buf.end(), p, p + 4);
+    }
+    void AppendU64(std::vector<unsigned char>& buf, unsigned long long v) {
+        const unsigned char* p = (const unsigned char*)&v;
+        buf.insert(buf.end(), p, p + 8);
+    }
+    void AppendPadded(std::vector<unsigned char>& buf, const void* data, long long numBytes) {
+        const unsigned char* p = (const unsigned char*)data;
+        buf.insert(buf.end(), p, p + numBytes);
+        buf.resize((size_t)PadTo8((long long)buf.size()), 0);
+    }
+}
+
+GlGeomMeshCache::GlGeomMeshCache(const char* filename)
+    : fileName(filename)
+{
+    if (MapFile() && !ReadIndex()) {
+        entries.clear();
+        UnmapFile();            // Wrong version or damaged: start again
+    }
+}
+
+GlGeomMeshCache::~GlGeomMeshCache()
+{
+    if (DefaultCache == this) {
+        DefaultCache = nullptr;
+    }
+    UnmapFile();
+}
+
+void GlGeomMeshCache::SetDefault(GlGeomMeshCache* cache)
+{
+    DefaultCache = cache;
+}
+
+GlGeomMeshCache* GlGeomMeshCache::Default()
+{
+    return DefaultCache;
+}
+
+bool GlGeomMeshCache::MapFile()
+{
+#ifdef _WIN32
+    HANDLE file = CreateFileA(fileName.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL,
+        OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (file == INVALID_HANDLE_VALUE) {
+        return false;
+    }
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file, &size) || size.QuadPart < HeaderSize) {
+        CloseHandle(file);
+        return false;
+    }
+    HANDLE mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+    void* view = (mapping != NULL) ? MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0) : NULL;
+    if (view == NULL) {
+        if (mapping != NULL) {
+            CloseHandle(mapping);
+        }
+        CloseHandle(file);
+        return false;
+    }
+    fileHandle = file;
+    mappingHandle = mapping;
+    mappedData = (unsigned char*)view;
+    mappedSize = size.QuadPart;
+#else
+    int fd = open(fileName.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0 || (long long)st.st_size < HeaderSize) {
+        close(fd);
+        return false;
+    }
+    void* view = mmap(0, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);              // The mapping stays valid
+    if (view == MAP_FAILED) {
+        return false;
+    }
+    mappedData = (unsigned char*)view;
+    mappedSize = (long long)st.st_size;
+#endif
+    return true;
+}
+
+void GlGeomMeshCache::UnmapFile()
+{
+    if (mappedData == nullptr) {
+        return;
+    }
+#ifdef _WIN32
+    UnmapViewOfFile(mappedData);
+    CloseHandle((HANDLE)mappingHandle);
+    CloseHandle((HANDLE)fileHandle);
+    fileHandle = nullptr;
+    mappingHandle = nullptr;
+#else
+    munmap(mappedData, (size_t)mappedSize);
+#endif
+    mappedData = nullptr;
+    mappedSize = 0;
+}
+
+// Read the header and the record headers of the mapped file.
+//    Only the record headers are read: the mesh data is not touched until used.
+bool GlGeomMeshCache::ReadIndex()
+{
+    const unsigned char* p = mappedData;
+    if (memcmp(p, Magic, 8) != 0 || ReadU32(p + 8) != FileVersion || ReadU32(p + 12) != MeshVersion
+        || (long long)ReadU64(p + 24) != mappedSize) {
+        return false;
+    }
+    unsigned int numMeshes = ReadU32(p + 16);
+    long long pos = HeaderSize;
+    for (unsigned int i = 0; i < numMeshes; i++) {
+        if (pos + RecordHeaderSize > mappedSize) {
+            return false;
+        }
+        const unsigned char* rec = mappedData + pos;
+        long long keyLength = ReadU32(rec);
+        Entry entry;
+        entry.vboBytes = (long long)ReadU64(rec + 8);
+        entry.eboBytes = (long long)ReadU64(rec + 16);
+        entry.checksum = ReadU64(rec + 24);
+        entry.checked = false;
+        // Checked against the file size first, so that the sum below cannot overflow.
+        if (entry.vboBytes < 0 || entry.eboBytes < 0
+            || entry.vboBytes > mappedSize || entry.eboBytes > mappedSize - entry.vboBytes) {
+            return false;
+        }
+        long long dataPos = pos + RecordHeaderSize + PadTo8(keyLength);
+        pos = dataPos + PadTo8(entry.vboBytes + entry.eboBytes);
+        if (pos > mappedSize) {
+            return false;
+        }
+        entry.data = mappedData + dataPos;
+        entries[std::string((const char*)rec + RecordHeaderSize, (size_t)keyLength)] = entry;
+    }
+    return true;
+}
+
+bool GlGeomMeshCache::Find(const std::string& key, long long vboBytes, long long eboBytes,
+    const void** vboData, const unsigned int** eboData)
+{
+    std::map<std::string, Entry>::iterator it = entries.find(key);
+    if (it == entries.end() || it->second.vboBytes != vboBytes || it->second.eboBytes != eboBytes) {
+        numMisses++;
+        return false;
+    }
+    Entry& entry = it->second;
+    if (!entry.checked) {
+        if (Checksum(entry.data, vboBytes + eboBytes) != entry.checksum) {
+            entries.erase(it);      // Corrupted: it will be calculated again and replaced
+            modified = true;
+            numMisses++;
+            return false;
+        }
+        entry.checked = true;
+    }
+    *vboData = entry.data;
+    *eboData = (const unsigned int*)(entry.data + vboBytes);
+    numHits++;
+    return true;
+}
+
+void GlGeomMeshCache::Add(const std::string& key, const void* vboData, long long vboBytes,
+    const unsigned int* eboData, long long eboBytes)
+{
+    std::vector<unsigned char> data((size_t)(vboBytes + eboBytes));
+    memcpy(data.data(), vboData, (size_t)vboBytes);
+    memcpy(data.data() + vboBytes, eboData, (size_t)eboBytes);
+
+    Entry entry;
+    entry.vboBytes = vboBytes;
+    entry.eboBytes = eboBytes;
+    entry.checksum = Checksum(data.data(), vboBytes + eboBytes);
+    entry.checked = true;
+    ownedData.push_back(std::vector<unsigned char>());
+    ownedData.back().swap(data);
+    entry.data = ownedData.back().data();
+    entries[key] = entry;
+    modified = true;
+}
+
+// Write all the meshes (from the old file and the added ones) to a new file.
+//    The file is then mapped again.
+bool GlGeomMeshCache::Save()
+{
+    if (!modified) {
+        return true;
+    }
+    std::vector<unsigned char> buf;
+    buf.insert(buf.end(), Magic, Magic + 8);
+    AppendU32(buf, FileVersion);
+    AppendU32(buf, MeshVersion);
+    AppendU32(buf, (unsigned int)entries.size());
+    AppendU32(buf, 0);
+    AppendU64(buf, 0);              // File size, filled in below
+    for (std::map<std::string, Entry>::const_iterator it = entries.begin(); it != entries.end(); ++it) {
+        const Entry& entry = it->second;
+        AppendU32(buf, (unsigned int)it->first.size());
+        AppendU32(buf, 0);
+        AppendU64(buf, (unsigned long long)entry.vboBytes);
+        AppendU64(buf, (unsigned long long)entry.eboBytes);
+        AppendU64(buf, entry.checksum);
+        AppendPadded(buf, it->first.data(), (long long)it->first.size());
+        AppendPadded(buf, entry.data, entry.vboBytes + entry.eboBytes);
+    }
+    unsigned long long fileSize = (unsigned long long)buf.size();
+    memcpy(buf.data() + 24, &fileSize, 8);
+
+    // The old file must be unmapped before it is overwritten.
+    entries.clear();
+    ownedData.clear();
+    UnmapFile();
+    modified = false;
+
+    FILE* outFile = fopen(fileName.c_str(), "wb");
+    bool ok = (outFile != nullptr);
+    if (ok) {
+        ok = (fwrite(buf.data(), 1, buf.size(), outFile) == buf.size());
+        ok = (fclose(outFile) == 0) && ok;
+    }
+    if (!ok) {
+        remove(fileName.c_str());
+        return false;
+    }
+    if (MapFile() && !ReadIndex()) {
+        entries.clear();
+        UnmapFile();
+    }
+    return true;
+}
@@ -0,0 +1,106 @@
+/*
+* GlGeomMeshCache.h - Version 0.9 - October 18, 2026
+*
+* A GlGeomMeshCache is a binary file holding the VBO and EBO data of
+*    GlGeomShape meshes, so that they do not need to be calculated again
+*    each time the program starts.
+*    Each mesh is stored exactly as it is loaded into the VBO and EBO, and
+*    is keyed by its mesh key (shape type, parameters, attribute locations
+*    and vertex format; see GlGeomBase::GetMeshKey()).
+*    The file is memory mapped (mmap, or MapViewOfFile on Windows), and the
+*    data is copied straight from the mapped file into the mapped VBO and EBO.
+*    Only the pages of the meshes actually used are read from disk.
+*
+*    Each mesh has a checksum, which is checked the first time it is used.
+*    A mesh that is missing, has the wrong size or a bad checksum is
+*    calculated as usual and added to the cache.  The whole file is ignored
+*    if it has a different format version, so the cache regenerates itself
+*    when it is stale. Increase MeshVersion if the shapes' meshes change.
+*
+* How to use:
+*     GlGeomMeshCache meshCache("SolarSystem.meshcache");
+*     GlGeomMeshCache::SetDefault(&meshCache);      // Used by InitializeAttribLocations()
+*     ... InitializeAttribLocations() for all the shapes ...
+*     meshCache.Save();          // Rewrites the file, only if meshes were added
+*     GlGeomMeshCache::SetDefault(nullptr);
+*
+* An addition to the software accompanying POSSIBLE SECOND EDITION TO the book
+*		3D Computer Graphics: A Mathematical Introduction with OpenGL,
+*		by S. Buss, Cambridge University Press, 2003.
+*   Not part of the book's software, and not written by its author.
+*
+* Software is "as-is" and carries no warranty.  It may be used without
+*   restriction, but if you modify it, please change the filenames to
+*   prevent confusion between different versions.
+* Web page of the book's software: http://math.ucsd.edu/~sbuss/MathCG2
+*/
+
+#pragma once
+#ifndef GLGEOM_MESH_CACHE_H
+#define GLGEOM_MESH_CACHE_H
+
+#include <map>
+#include <string>
+#include <vector>
+
+class GlGeomMeshCache
+{
+public:
+    static const unsigned int FileVersion = 1;     // The file format
+    static const unsigned int MeshVersion = 2;     // The meshes calculated by the GlGeomShape classes (2: GlGeomParametric)
+
+    // Opens and maps the file, if it exists and is valid.
+    GlGeomMeshCache(const char* filename);
+    ~GlGeomMeshCache();
+
+    GlGeomMeshCache(const GlGeomMeshCache&) = delete;
+    GlGeomMeshCache& operator=(const GlGeomMeshCache&) = delete;
+
+    // The cache used by GlGeomBase (nullptr for none, the default).
+    static void SetDefault(GlGeomMeshCache* cache);
+    static GlGeomMeshCache* Default();
+
+    // Find(): Look up a mesh with vboBytes bytes of vertex data and eboBytes bytes of elements.
+    //    Returns false if not found, or if the cached data is stale.
+    bool Find(const std::string& key, long long vboBytes, long long eboBytes,
+        const void** vboData, const unsigned int** eboData);
+    // Add(): Add a mesh (the data is copied). Replaces any old mesh with the same key.
+    void Add(const std::string& key, const void* vboData, long long vboBytes,
+        const unsigned int* eboData, long long eboBytes);
+
+    // Save(): Write the file, if any meshes were added. Returns false on failure.
+    bool Save();
+
+    bool IsMapped() const { return mappedData != nullptr; }    // True if a valid file was mapped
+    int GetNumMeshes() const { return (int)entries.size(); }
+    int GetNumHits() const { return numHits; }
+    int GetNumMisses() const { return numMisses; }
+
+private:
+    struct Entry {
+        const unsigned char* data;      // The vertex data, followed by the elements
+        long long vboBytes;
+        long long eboBytes;
+        unsigned long long checksum;
+        bool checked;                   // The checksum has been checked
+    };
+
+    std::string fileName;
+    std::map<std::string, Entry> entries;
+    std::vector<std::vector<unsigned char> > ownedData;     // Data of the meshes added by Add()
+    bool modified = false;
+    int numHits = 0;
+    int numMisses = 0;
+
+    // The memory mapped file
+    unsigned char* mappedData = nullptr;
+    long long mappedSize = 0;
+    void* fileHandle = nullptr;         // Windows file and mapping handles
+    void* mappingHandle = nullptr;
+
+    bool MapFile();
+    void UnmapFile();
+    bool ReadIndex();
+};
+
+#endif  // GLGEOM_MESH_CACHE_H
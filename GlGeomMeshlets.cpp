@@ -0,0 +1,329 @@
+/*
+* GlGeomMeshlets.cpp - Version 0.9 - October 18, 2026
+*
+* Meshlets (small clusters of triangles) with culling for GlGeomShape objects.
+*    See GlGeomMeshlets.h for more information.
+*
+* An addition to the software accompanying POSSIBLE SECOND EDITION TO the book
+*		3D Computer Graphics: A Mathematical Introduction with OpenGL,
+*		by S. Buss, Cambridge University Press, 2003.
+*   Not part of the book's software, and not written by its author.
+*
+* Software is "as-is" and carries no warranty.  It may be used without
+*   restriction, but if you modify it, please change the filenames to
+*   prevent confusion between different versions.
+* Web page of the book's software: http://math.ucsd.edu/~sbuss/MathCG2
+*/
+
+// Use the static library (so glew32.dll is not needed):
+#define GLEW_STATIC
+#include <GL/glew.h>
+#include <GLFW/glfw3.h>
+
+#include "GlGeomMeshlets.h"
+#include "GlGeomBudget.h"
+#include "GlGeomMesh.h"
+#include "LinearR4.h"
+#include "MathMisc.h"
+#include "assert.h"
+#include <stddef.h>
+
+GlGeomMeshlets::~GlGeomMeshlets()
+{
+    if (theEBO != 0) {
+        glDeleteBuffers(1, &theEBO);
+        if (GlGeomBudget::Default() != nullptr) {
+            GlGeomBudget::Default()->RecordRelease(this);
+        }
+    }
+}
+
+// The unit normal of a triangle (zero if it is degenerate)
+static VectorR3 TriangleNormal(const float* p0, const float* p1, const float* p2)
+{
+    VectorR3 u(p1[0] - p0[0], p1[1] - p0[1], p1[2] - p0[2]);
+    VectorR3 v(p2[0] - p0[0], p2[1] - p0[1], p2[2] - p0[2]);
+    VectorR3 n = u * v;         // Cross product
+    double len = n.Norm();
+    if (len > 0.0) {
+        n /= len;
+    }
+    return n;
+}
+
+void GlGeomMeshlets::Build(const GlGeomMesh& mesh, int numGroups, const int* groupFirst, const int* groupNum)
+{
+    meshlets.clear();
+    elements.clear();
+    groupStart.clear();
+    for (int i = 0; i < numGroups; i++) {
+        groupStart.push_back((int)meshlets.size());
+        BuildGroup(mesh, groupFirst[i], groupNum[i]);
+    }
+    groupStart.push_back((int)meshlets.size());
+}
+
+// Make the meshlets for one group of triangles.
+//    Each meshlet starts with the first unused triangle (in the original order),
+//    and grows by adding neighboring triangles: those adding the fewest new vertices
+//    first, and then those closest to the starting triangle.
+//    Triangles whose normal is more than about 45 degrees from the starting
+//    triangle's normal are not added, so the normal cones stay narrow.
+void GlGeomMeshlets::BuildGroup(const GlGeomMesh& mesh, int firstElement, int numElements)
+{
+    const unsigned int* tris = mesh.elements.data() + firstElement;
+    int numTris = numElements / 3;
+    int numVertices = mesh.GetNumVertices();
+
+    // The triangles around each vertex
+    std::vector<int> vertTriStart(numVertices + 1, 0);
+    for (int i = 0; i < 3 * numTris; i++) {
+        vertTriStart[tris[i] + 1]++;
+    }
+    for (int v = 0; v < numVertices; v++) {
+        vertTriStart[v + 1] += vertTriStart[v];
+    }
+    std::vector<int> vertTris(3 * numTris);
+    std::vector<int> fill(vertTriStart.begin(), vertTriStart.end() - 1);
+    for (int i = 0; i < 3 * numTris; i++) {
+        vertTris[fill[tris[i]]++] = i / 3;
+    }
+
+    std::vector<char> used(numTris, 0);
+    std::vector<int> vertMeshlet(numVertices, -1);      // The last meshlet containing each vertex
+    std::vector<int> candidates;
+    int seed = 0;
+    while (true) {
+        while (seed < numTris && used[seed]) {
+            seed++;
+        }
+        if (seed == numTris) {
+            break;
+        }
+        int meshletNum = (int)meshlets.size();
+        Meshlet meshlet;
+        meshlet.firstElement = (int)elements.size();
+        const float* s0 = mesh.GetPosition(tris[3 * seed]);
+        const float* s1 = mesh.GetPosition(tris[3 * seed + 1]);
+        const float* s2 = mesh.GetPosition(tris[3 * seed + 2]);
+        float seedCenter[3];
+        for (int k = 0; k < 3; k++) {
+            seedCenter[k] = (s0[k] + s1[k] + s2[k]) / 3.0f;
+        }
+        VectorR3 seedNormal = TriangleNormal(s0, s1, s2);
+
+        int numVerts = 0;
+        int numTrisIn = 0;
+        candidates.clear();
+        int tri = seed;
+        while (tri >= 0) {
+            used[tri] = 1;
+            numTrisIn++;
+            for (int k = 0; k < 3; k++) {
+                unsigned int v = tris[3 * tri + k];
+                elements.push_back(v);
+                if (vertMeshlet[v] != meshletNum) {
+                    vertMeshlet[v] = meshletNum;
+                    numVerts++;
+                    for (int j = vertTriStart[v]; j < vertTriStart[v + 1]; j++) {
+                        if (!used[vertTris[j]]) {
+                            candidates.push_back(vertTris[j]);
+                        }
+                    }
+                }
+            }
+            if (numTrisIn == MaxTriangles) {
+                break;
+            }
+
+            // Choose the next triangle
+            int best = -1;
+            int bestNew = 4;
+            float bestDistSq = 0.0f;
+            for (size_t c = 0; c < candidates.size(); ) {
+                int t = candidates[c];
+                if (used[t]) {
+                    candidates[c] = candidates.back();
+                    candidates.pop_back();
+                    continue;
+                }
+                c++;
+                int numNew = 0;
+                float distSq = 0.0f;
+                for (int k = 0; k < 3; k++) {
+                    unsigned int v = tris[3 * t + k];
+                    numNew += (vertMeshlet[v] != meshletNum) ? 1 : 0;
+                    const float* p = mesh.GetPosition(v);
+                    for (int d = 0; d < 3; d++) {
+                        distSq += (p[d] - seedCenter[d])*(p[d] - seedCenter[d]);
+                    }
+                }
+                if (numVerts + numNew > MaxVertices) {
+                    continue;
+                }
+                const float* p0 = mesh.GetPosition(tris[3 * t]);
+                const float* p1 = mesh.GetPosition(tris[3 * t + 1]);
+                const float* p2 = mesh.GetPosition(tris[3 * t + 2]);
+                if ((TriangleNormal(p0, p1, p2) ^ seedNormal) < MinNormalDot) {
+                    continue;       // Keep the normal cone narrow
+                }
+                if (numNew < bestNew || (numNew == bestNew && distSq < bestDistSq)) {
+                    best = t;
+                    bestNew = numNew;
+                    bestDistSq = distSq;
+                }
+            }
+            tri = best;
+        }
+        meshlet.numElements = (int)elements.size() - meshlet.firstElement;
+        CalcBounds(mesh, meshlet);
+        meshlets.push_back(meshlet);
+    }
+}
+
+// The bounding sphere is centered at the center of the bounding box.
+// The normal cone is around the average of the triangles' unit normals.
+void GlGeomMeshlets::CalcBounds(const GlGeomMesh& mesh, Meshlet& meshlet) const
+{
+    const unsigned int* elts = elements.data() + meshlet.firstElement;
+    float boxMin[3] = { 1.0e30f, 1.0e30f, 1.0e30f };
+    float boxMax[3] = { -1.0e30f, -1.0e30f, -1.0e30f };
+    for (int i = 0; i < meshlet.numElements; i++) {
+        const float* p = mesh.GetPosition(elts[i]);
+        for (int k = 0; k < 3; k++) {
+            boxMin[k] = Min(boxMin[k], p[k]);
+            boxMax[k] = Max(boxMax[k], p[k]);
+        }
+    }
+    for (int k = 0; k < 3; k++) {
+        meshlet.center[k] = 0.5f*(boxMin[k] + boxMax[k]);
+    }
+    float radiusSq = 0.0f;
+    for (int i = 0; i < meshlet.numElements; i++) {
+        const float* p = mesh.GetPosition(elts[i]);
+        VectorR3 d(p[0] - meshlet.center[0], p[1] - meshlet.center[1], p[2] - meshlet.center[2]);
+        radiusSq = Max(radiusSq, (float)d.NormSq());
+    }
+    meshlet.radius = sqrtf(radiusSq);
+
+    int numTris = meshlet.numElements / 3;
+    std::vector<VectorR3> normals(numTris);
+    VectorR3 axis(0.0, 0.0, 0.0);
+    for (int t = 0; t < numTris; t++) {
+        const float* p0 = mesh.GetPosition(elts[3 * t]);
+        const float* p1 = mesh.GetPosition(elts[3 * t + 1]);
+        const float* p2 = mesh.GetPosition(elts[3 * t + 2]);
+        VectorR3 u(p1[0] - p0[0], p1[1] - p0[1], p1[2] - p0[2]);
+        VectorR3 v(p2[0] - p0[0], p2[1] - p0[1], p2[2] - p0[2]);
+        normals[t] = u * v;         // Cross product
+        double len = normals[t].Norm();
+        if (len > 0.0) {
+            normals[t] /= len;
+            axis += normals[t];
+        }
+    }
+    meshlet.coneSin = 2.0f;         // No cone, unless all normals are within 90 degrees of the axis
+    meshlet.coneAxis[0] = meshlet.coneAxis[1] = meshlet.coneAxis[2] = 0.0f;
+    double axisLen = axis.Norm();
+    if (axisLen < 1.0e-6) {
+        return;
+    }
+    axis /= axisLen;
+    double minDot = 1.0;
+    for (int t = 0; t < numTris; t++) {
+        if (normals[t].NormSq() > 0.0) {
+            minDot = Min(minDot, normals[t] ^ axis);
+        }
+    }
+    if (minDot > 0.0) {
+        meshlet.coneSin = (float)sqrt(1.0 - minDot * minDot);
+        meshlet.coneAxis[0] = (float)axis.x;
+        meshlet.coneAxis[1] = (float)axis.y;
+        meshlet.coneAxis[2] = (float)axis.z;
+    }
+}
+
+void GlGeomMeshlets::Upload()
+{
+    if (theEBO == 0) {
+        glGenBuffers(1, &theEBO);
+    }
+    // Bound as GL_COPY_WRITE_BUFFER, so the element buffer of the current VAO is not changed.
+    glBindBuffer(GL_COPY_WRITE_BUFFER, theEBO);
+    glBufferData(GL_COPY_WRITE_BUFFER, (GLsizeiptr)(elements.size() * sizeof(unsigned int)),
+        elements.data(), GL_STATIC_DRAW);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+    if (GlGeomBudget::Default() != nullptr) {
+        GlGeomBudget::Default()->RecordAllocation(this, (long long)elements.size() * sizeof(unsigned int));
+    }
+}
+
+// A meshlet is culled if its bounding sphere is outside one of the planes of the
+//    view frustum, or if all its normals point away from every point of its bounding sphere.
+//    Everything is done in model coordinates: the frustum planes come from the rows of
+//    projection*modelview, and the eye position from the inverse of the modelview matrix.
+int GlGeomMeshlets::Cull(const LinearMapR4& modelview, const LinearMapR4& projection, int group, int baseVertex)
+{
+    assert(group >= 0 && group < GetNumGroups());
+    LinearMapR4 mvp = projection * modelview;
+    double planes[6][4];
+    const double rows[4][4] = {
+        { mvp.m11, mvp.m12, mvp.m13, mvp.m14 }, { mvp.m21, mvp.m22, mvp.m23, mvp.m24 },
+        { mvp.m31, mvp.m32, mvp.m33, mvp.m34 }, { mvp.m41, mvp.m42, mvp.m43, mvp.m44 } };
+    for (int i = 0; i < 3; i++) {
+        for (int k = 0; k < 4; k++) {
+            planes[2 * i][k] = rows[3][k] + rows[i][k];
+            planes[2 * i + 1][k] = rows[3][k] - rows[i][k];
+        }
+    }
+    double planeNorms[6];
+    for (int i = 0; i < 6; i++) {
+        planeNorms[i] = sqrt(planes[i][0] * planes[i][0] + planes[i][1] * planes[i][1] + planes[i][2] * planes[i][2]);
+    }
+
+    // The eye position (perspective) or the view direction (orthographic), in model coordinates.
+    LinearMapR4 inverse = modelview.Inverse();
+    bool perspective = (projection.m43 != 0.0);
+    VectorR3 eyePos(inverse.m14, inverse.m24, inverse.m34);
+    VectorR3 viewDir(-inverse.m13, -inverse.m23, -inverse.m33);
+    double viewDirLen = viewDir.Norm();
+
+    drawCounts.clear();
+    drawOffsets.clear();
+    drawBaseVertices.clear();
+    numTrianglesVisible = 0;
+    int runEnd = -1;            // Element just after the last draw
+    for (int i = groupStart[group]; i < groupStart[group + 1]; i++) {
+        const Meshlet& m = meshlets[i];
+        VectorR3 center(m.center[0], m.center[1], m.center[2]);
+        bool culled = false;
+        for (int p = 0; p < 6 && !culled; p++) {
+            double dist = planes[p][0] * center.x + planes[p][1] * center.y + planes[p][2] * center.z + planes[p][3];
+            culled = (dist < -m.radius * planeNorms[p]);
+        }
+        if (!culled && m.coneSin <= 1.0f) {
+            VectorR3 axis(m.coneAxis[0], m.coneAxis[1], m.coneAxis[2]);
+            if (perspective) {
+                VectorR3 toCenter = center - eyePos;
+                culled = ((axis ^ toCenter) > m.coneSin * toCenter.Norm() + m.radius * (1.0 + m.coneSin));
+            }
+            else {
+                culled = ((axis ^ viewDir) > m.coneSin * viewDirLen);
+            }
+        }
+        if (culled) {
+            continue;
+        }
+        numTrianglesVisible += m.numElements / 3;
+        if (m.firstElement == runEnd) {
+            drawCounts.back() += m.numElements;         // Extend the last draw
+        }
+        else {
+            drawCounts.push_back(m.numElements);
+            drawOffsets.push_back((const void*)((size_t)m.firstElement * sizeof(unsigned int)));
+            drawBaseVertices.push_back(baseVertex);
+        }
+        runEnd = m.firstElement + m.numElements;
+    }
+    return (int)drawCounts.size();
+}
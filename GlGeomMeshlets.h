@@ -0,0 +1,106 @@
+/*
+* GlGeomMeshlets.h - Version 0.9 - October 18, 2026
+*
+* GlGeomMeshlets splits the triangles of a GlGeomShape into small clusters
+*    ("meshlets") of at most 64 vertices and 124 triangles. Each meshlet has
+*    a bounding sphere and a cone containing its triangles' normals.
+*    Before rendering, meshlets which are outside the view frustum, or whose
+*    triangles all face away from the viewer, are culled on the CPU.  The
+*    remaining meshlets are rendered with a single glMultiDrawElements.
+*    For a sphere, about a quarter to a third of the triangles are never sent
+*    to the rasterizer, and more when the sphere is partly off the screen.
+*
+*    The meshlets have their own EBO, holding the shape's triangles
+*    reordered meshlet by meshlet.  The triangles in each meshlet are
+*    neighbors, grown from a starting triangle, so the meshlets are compact.
+*    The VBO is not changed.
+*
+* Use via GlGeomBase::SetUseMeshlets() and GlGeomBase::RenderCulled().
+*    Culling back-facing meshlets is only correct if back faces are culled
+*    anyway (glEnable(GL_CULL_FACE)).
+*    The tests are done in the shape's model coordinates, so the modelview
+*    matrix may contain non-uniform scaling.
+*
+* An addition to the software accompanying POSSIBLE SECOND EDITION TO the book
+*		3D Computer Graphics: A Mathematical Introduction with OpenGL,
+*		by S. Buss, Cambridge University Press, 2003.
+*   Not part of the book's software, and not written by its author.
+*
+* Software is "as-is" and carries no warranty.  It may be used without
+*   restriction, but if you modify it, please change the filenames to
+*   prevent confusion between different versions.
+* Web page of the book's software: http://math.ucsd.edu/~sbuss/MathCG2
+*/
+
+#pragma once
+#ifndef GLGEOM_MESHLETS_H
+#define GLGEOM_MESHLETS_H
+
+#include <vector>
+
+class GlGeomMesh;
+class LinearMapR4;
+
+class GlGeomMeshlets
+{
+public:
+    static const int MaxVertices = 64;
+    static const int MaxTriangles = 124;
+    static constexpr double MinNormalDot = 0.7;     // Cosine of the maximum angle from the first triangle's normal
+
+    struct Meshlet {
+        int firstElement;       // First element in the meshlet EBO
+        int numElements;        // Three per triangle
+        float center[3];        // Bounding sphere (model coordinates)
+        float radius;
+        float coneAxis[3];      // Average normal direction
+        float coneSin;          // Sine of the cone's half angle (greater than 1 if no cone)
+    };
+
+    GlGeomMeshlets() {}
+    ~GlGeomMeshlets();
+
+    GlGeomMeshlets(const GlGeomMeshlets&) = delete;
+    GlGeomMeshlets& operator=(const GlGeomMeshlets&) = delete;
+
+    // Build(): Make the meshlets for groups of GL_TRIANGLES elements of the mesh.
+    //    Group i is elements groupFirst[i] to groupFirst[i]+groupNum[i]-1.
+    //    Meshlets never mix triangles from different groups.
+    //    The mesh's element numbers must be the same as in the VBO.
+    void Build(const GlGeomMesh& mesh, int numGroups, const int* groupFirst, const int* groupNum);
+    // Upload(): Load the reordered elements into the meshlets' EBO. Needs an OpenGL context.
+    void Upload();
+
+    // Cull(): Find the visible meshlets of a group.
+    //    Adjacent visible meshlets are merged into a single draw.
+    //    Returns the number of draws; see GetDrawCounts(), GetDrawOffsets(), GetDrawBaseVertices().
+    //    baseVertex is added to the elements (for shapes in a GlGeomArena).
+    int Cull(const LinearMapR4& modelview, const LinearMapR4& projection, int group, int baseVertex = 0);
+
+    unsigned int GetEBO() const { return theEBO; }
+    int GetNumGroups() const { return (int)groupStart.size() - 1; }
+    int GetNumMeshlets() const { return (int)meshlets.size(); }
+    const Meshlet& GetMeshlet(int i) const { return meshlets[i]; }
+
+    // The draws from the last Cull(), for glMultiDrawElements(BaseVertex).
+    const int* GetDrawCounts() const { return drawCounts.data(); }
+    const void* const* GetDrawOffsets() const { return drawOffsets.data(); }
+    const int* GetDrawBaseVertices() const { return drawBaseVertices.data(); }
+    int GetNumTrianglesVisible() const { return numTrianglesVisible; }
+
+private:
+    std::vector<Meshlet> meshlets;
+    std::vector<int> groupStart;            // Meshlets of group i are groupStart[i] to groupStart[i+1]-1
+    std::vector<unsigned int> elements;     // Triangles, reordered meshlet by meshlet
+    unsigned int theEBO = 0;
+
+    std::vector<int> drawCounts;
+    std::vector<const void*> drawOffsets;
+    std::vector<int> drawBaseVertices;
+    int numTrianglesVisible = 0;
+
+    void BuildGroup(const GlGeomMesh& mesh, int firstElement, int numElements);
+    void CalcBounds(const GlGeomMesh& mesh, Meshlet& meshlet) const;
+};
+
+#endif  // GLGEOM_MESHLETS_H
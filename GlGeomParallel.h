@@ -0,0 +1,64 @@
+/*
+* GlGeomParallel.h - Version 0.9 - October 18, 2026
+*
+* GlGeomParallelFor() runs a loop over independent pieces of a mesh
+*    (for instance, the faces of an icosphere) on several threads.
+*    It is used by the GlGeomShape classes to calculate large meshes.
+*    Small meshes are calculated on the calling thread, since starting
+*    threads would cost more than it saves.
+*    The loop body must only write to memory that no other iteration writes to.
+*    No OpenGL calls may be made from the loop body.
+*
+* An addition to the software accompanying POSSIBLE SECOND EDITION TO the book
+*		3D Computer Graphics: A Mathematical Introduction with OpenGL,
+*		by S. Buss, Cambridge University Press, 2003.
+*   Not part of the book's software, and not written by its author.
+*
+* Software is "as-is" and carries no warranty.  It may be used without
+*   restriction, but if you modify it, please change the filenames to
+*   prevent confusion between different versions.
+* Web page of the book's software: http://math.ucsd.edu/~sbuss/MathCG2
+*/
+
+#pragma once
+#ifndef GLGEOM_PARALLEL_H
+#define GLGEOM_PARALLEL_H
+
+#include <thread>
+#include <vector>
+
+// Meshes with fewer vertices than this are calculated on a single thread.
+const long long GlGeomMinParallelVertices = 16384;
+
+// Call func(i) for i = 0, 1, ..., count-1.
+//    numVertices - the size of the whole job, used to decide whether to use threads.
+template<typename Func>
+inline void GlGeomParallelFor(int count, long long numVertices, Func func)
+{
+    int numThreads = (int)std::thread::hardware_concurrency();
+    if (numThreads > count) {
+        numThreads = count;
+    }
+    if (numThreads < 2 || numVertices < GlGeomMinParallelVertices) {
+        for (int i = 0; i < count; i++) {
+            func(i);
+        }
+        return;
+    }
+    std::vector<std::thread> threads;
+    for (int t = 1; t < numThreads; t++) {
+        threads.push_back(std::thread([=]() {
+            for (int i = t; i < count; i += numThreads) {
+                func(i);
+            }
+        }));
+    }
+    for (int i = 0; i < count; i += numThreads) {
+        func(i);
+    }
+    for (size_t t = 0; t < threads.size(); t++) {
+        threads[t].join();
+    }
+}
+
+#endif  // GLGEOM_PARALLEL_H
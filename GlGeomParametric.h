@@ -0,0 +1,213 @@
+/*
+* GlGeomParametric.h - Version 0.9 - October 18, 2026
+*
+* GlGeomParametric<SurfaceFn, Layout> generates the vertices and GL_TRIANGLES
+*    elements of a parametric surface on a (u,v) grid, for the GlGeomShape
+*    classes.  The grid, seams, poles and texture coordinates are handled here;
+*    the surface is given by the SurfaceFn class.
+*    The vertex layout (whether normals and texture coordinates are written) is
+*    a template parameter, so there are no per-vertex tests of the layout.
+*    The surface is evaluated a row at a time, with the sines and cosines
+*    of the v angles precomputed: the SurfaceFn's loop over the row is plain
+*    arithmetic on arrays, which compilers vectorize with SIMD instructions.
+*    The vertices are written straight into the VBO data buffer.
+*
+* The grid:
+*    u is the angle around the y-axis, 0 to 2*pi, in numU steps.
+*    v is the angle 0 to pi from the south pole to the north pole (if SurfaceFn::Poles),
+*        or 0 to 2*pi around a closed loop (otherwise), in numV steps.
+*    The vertices are numbered u column by u column. With poles, vertices 0 and 1
+*        are the south and north poles.  Without texture coordinates, the
+*        vertices on the seams are not repeated.
+*    Texture coordinates are s = u/(2*pi) and t = v/(v range), with s = 0.5 at the poles.
+*
+* A SurfaceFn class has:
+*    static const bool Poles;     -- true for a sphere-like surface, false for a torus-like surface
+*    void EvalRow(float cosU, float sinU, int n, const float* cosV, const float* sinV,
+*                 GlGeomParametricRow row) const;
+*        -- Set the positions and unit normals of the n points with angles u and v[0], ..., v[n-1].
+*
+* An addition to the software accompanying POSSIBLE SECOND EDITION TO the book
+*		3D Computer Graphics: A Mathematical Introduction with OpenGL,
+*		by S. Buss, Cambridge University Press, 2003.
+*   Not part of the book's software, and not written by its author.
+*
+* Software is "as-is" and carries no warranty.  It may be used without
+*   restriction, but if you modify it, please change the filenames to
+*   prevent confusion between different versions.
+* Web page of the book's software: http://math.ucsd.edu/~sbuss/MathCG2
+*/
+
+#pragma once
+#ifndef GLGEOM_PARAMETRIC_H
+#define GLGEOM_PARAMETRIC_H
+
+#include "GlGeomConstMesh.h"        // For GlGeomConstLayout
+#include "MathMisc.h"
+#include <math.h>
+#include <vector>
+
+// A row of points on the surface, with the coordinates in separate arrays.
+//    The arrays never overlap each other, or the arrays of cosines and sines.
+//    (__restrict tells the compiler this, so it can vectorize without run time checks.
+//     EvalRow() takes the row by value, since compilers only trust __restrict in parameters.)
+struct GlGeomParametricRow {
+    float* __restrict x;
+    float* __restrict y;
+    float* __restrict z;
+    float* __restrict nx;
+    float* __restrict ny;
+    float* __restrict nz;
+};
+
+template<class SurfaceFn, GlGeomConstLayout Layout>
+class GlGeomParametric
+{
+public:
+    static const bool Poles = SurfaceFn::Poles;
+    static const bool HasNormals = GlGeomConstHasNormals(Layout);
+    static const bool HasTexCoords = GlGeomConstHasTexCoords(Layout);
+
+    static int NumVertices(int numU, int numV) {
+        int numCols = HasTexCoords ? numU + 1 : numU;
+        return Poles ? numCols * (numV - 1) + 2 : numCols * ColumnLength(numV);
+    }
+    static int NumElements(int numU, int numV) { return 6 * numU * (Poles ? numV - 1 : numV); }
+
+    // The vertex number of grid point (i,j): i is the u step, and j is the v step.
+    static int VertexNumber(int numU, int numV, int i, int j) {
+        int ii = HasTexCoords ? i : (i % numU);
+        if (Poles) {
+            return (j == 0) ? 0 : (j == numV) ? 1 : (numV - 1)*ii + j + 1;
+        }
+        return ii * ColumnLength(numV) + (HasTexCoords ? j : (j % numV));
+    }
+
+    static void CalcVertices(const SurfaceFn& surface, int numU, int numV,
+        float* VBOdataBuffer, int vertPosOffset, int vertNormalOffset, int vertTexCoordsOffset,
+        unsigned int stride);
+    static void CalcElements(int numU, int numV, unsigned int* EBOdataBuffer);
+
+private:
+    static int ColumnLength(int numV) { return HasTexCoords ? numV + 1 : numV; }
+};
+
+template<class SurfaceFn, GlGeomConstLayout Layout>
+void GlGeomParametric<SurfaceFn, Layout>::CalcVertices(const SurfaceFn& surface, int numU, int numV,
+    float* VBOdataBuffer, int vertPosOffset, int vertNormalOffset, int vertTexCoordsOffset,
+    unsigned int stride)
+{
+    // The v angles are the same in every row
+    int n = numV + 1;
+    std::vector<float> buffer(8 * n);
+    float* cosV = buffer.data();
+    float* sinV = cosV + n;
+    float vRange = Poles ? (float)PI : (float)PI2;
+    for (int j = 0; j < n; j++) {
+        float v = vRange * (float)(Poles ? j : (j % numV)) / (float)numV;
+        cosV[j] = cosf(v);
+        sinV[j] = (Poles && j == numV) ? 0.0f : sinf(v);
+    }
+    GlGeomParametricRow row;
+    row.x = sinV + n;
+    row.y = row.x + n;
+    row.z = row.y + n;
+    row.nx = row.z + n;
+    row.ny = row.nx + n;
+    row.nz = row.ny + n;
+
+    int lastU = HasTexCoords ? numU : numU - 1;
+    for (int i = 0; i <= lastU; i++) {
+        float u = (float)PI2 * (float)(i % numU) / (float)numU;
+        surface.EvalRow(cosf(u), sinf(u), n, cosV, sinV, row);
+        float sTexCd = (float)i / (float)numU;
+        for (int j = 0; j < n; j++) {
+            bool isPole = Poles && (j == 0 || j == numV);
+            if (isPole ? (i != 0) : (!Poles && !HasTexCoords && j == numV)) {
+                continue;       // Not repeated
+            }
+            float* vPtr = VBOdataBuffer + stride * VertexNumber(numU, numV, i, j);
+            vPtr[vertPosOffset] = row.x[j];
+            vPtr[vertPosOffset + 1] = row.y[j];
+            vPtr[vertPosOffset + 2] = row.z[j];
+            if (HasNormals) {
+                vPtr[vertNormalOffset] = row.nx[j];
+                vPtr[vertNormalOffset + 1] = row.ny[j];
+                vPtr[vertNormalOffset + 2] = row.nz[j];
+            }
+            if (HasTexCoords) {
+                vPtr[vertTexCoordsOffset] = isPole ? 0.5f : sTexCd;
+                vPtr[vertTexCoordsOffset + 1] = (float)j / (float)numV;
+            }
+        }
+    }
+}
+
+// The triangles, u column by u column.
+//    With poles, the same order as GlGeomSphere has always used; otherwise as GlGeomTorus.
+template<class SurfaceFn, GlGeomConstLayout Layout>
+void GlGeomParametric<SurfaceFn, Layout>::CalcElements(int numU, int numV, unsigned int* EBOdataBuffer)
+{
+    unsigned int* toEbo = EBOdataBuffer;
+    for (int i = 0; i < numU; i++) {
+        if (Poles) {
+            for (int j = 0; j < numV - 1; j++) {
+                *(toEbo++) = VertexNumber(numU, numV, i, j);
+                *(toEbo++) = VertexNumber(numU, numV, i + 1, j + 1);
+                *(toEbo++) = VertexNumber(numU, numV, i, j + 1);
+
+                *(toEbo++) = VertexNumber(numU, numV, i, j + 1);
+                *(toEbo++) = VertexNumber(numU, numV, i + 1, j + 1);
+                *(toEbo++) = VertexNumber(numU, numV, i + 1, j + 2);
+            }
+        }
+        else {
+            for (int j = 0; j < numV; j++) {
+                *(toEbo++) = VertexNumber(numU, numV, i + 1, j);
+                *(toEbo++) = VertexNumber(numU, numV, i, j + 1);
+                *(toEbo++) = VertexNumber(numU, numV, i, j);
+
+                *(toEbo++) = VertexNumber(numU, numV, i + 1, j);
+                *(toEbo++) = VertexNumber(numU, numV, i + 1, j + 1);
+                *(toEbo++) = VertexNumber(numU, numV, i, j + 1);
+            }
+        }
+    }
+}
+
+// GlGeomParametricCalc() - for use in CalcVboAndEbo(): picks the layout from the offsets
+//    (negative if normals or texture coordinates are not wanted).
+//    EBOdataBuffer may be nullptr, if only the vertices are wanted.
+template<class SurfaceFn>
+void GlGeomParametricCalc(const SurfaceFn& surface, int numU, int numV,
+    float* VBOdataBuffer, unsigned int* EBOdataBuffer,
+    int vertPosOffset, int vertNormalOffset, int vertTexCoordsOffset, unsigned int stride)
+{
+    if (vertNormalOffset >= 0 && vertTexCoordsOffset >= 0) {
+        typedef GlGeomParametric<SurfaceFn, GlGeomConstLayout::PositionsNormalsTexCoords> Generator;
+        Generator::CalcVertices(surface, numU, numV, VBOdataBuffer, vertPosOffset, vertNormalOffset, vertTexCoordsOffset, stride);
+    }
+    else if (vertNormalOffset >= 0) {
+        typedef GlGeomParametric<SurfaceFn, GlGeomConstLayout::PositionsNormals> Generator;
+        Generator::CalcVertices(surface, numU, numV, VBOdataBuffer, vertPosOffset, vertNormalOffset, vertTexCoordsOffset, stride);
+    }
+    else if (vertTexCoordsOffset >= 0) {
+        typedef GlGeomParametric<SurfaceFn, GlGeomConstLayout::PositionsTexCoords> Generator;
+        Generator::CalcVertices(surface, numU, numV, VBOdataBuffer, vertPosOffset, vertNormalOffset, vertTexCoordsOffset, stride);
+    }
+    else {
+        typedef GlGeomParametric<SurfaceFn, GlGeomConstLayout::Positions> Generator;
+        Generator::CalcVertices(surface, numU, numV, VBOdataBuffer, vertPosOffset, vertNormalOffset, vertTexCoordsOffset, stride);
+    }
+    if (EBOdataBuffer != nullptr) {
+        // The elements only depend on whether there are texture coordinates
+        if (vertTexCoordsOffset >= 0) {
+            GlGeomParametric<SurfaceFn, GlGeomConstLayout::PositionsTexCoords>::CalcElements(numU, numV, EBOdataBuffer);
+        }
+        else {
+            GlGeomParametric<SurfaceFn, GlGeomConstLayout::Positions>::CalcElements(numU, numV, EBOdataBuffer);
+        }
+    }
+}
+
+#endif  // GLGEOM_PARAMETRIC_H
@@ -0,0 +1,114 @@
+/*
+* GlGeomRegistry.cpp - Version 0.9 - October 18, 2026
+*
+* Registry of shared VAO/VBO/EBO's for the GlGeomShape classes.
+*   See GlGeomRegistry.h for more information.
+*
+* An addition to the software accompanying POSSIBLE SECOND EDITION TO the book
+*		3D Computer Graphics: A Mathematical Introduction with OpenGL,
+*		by S. Buss, Cambridge University Press, 2003.
+*   Not part of the book's software, and not written by its author.
+*
+* Software is "as-is" and carries no warranty.  It may be used without
+*   restriction, but if you modify it, please change the filenames to
+*   prevent confusion between different versions.
+* Web page of the book's software: http://math.ucsd.edu/~sbuss/MathCG2
+*/
+
+// Use the static library (so glew32.dll is not needed):
+#define GLEW_STATIC
+#include <GL/glew.h>
+#include <GLFW/glfw3.h>
+
+#include "GlGeomRegistry.h"
+#include "GlGeomStateCache.h"
+#include "GlGeomBudget.h"
+#include "assert.h"
+#include <map>
+
+namespace {
+    struct SharedMesh {
+        unsigned int vao;
+        unsigned int vbo;
+        unsigned int ebo;
+        int refCount;
+    };
+
+    // The map is allocated on first use and never deleted, so that
+    //    global and static GlGeomShape objects can still release
+    //    their meshes during program exit.
+    std::map<std::string, SharedMesh>& TheMeshes()
+    {
+        static std::map<std::string, SharedMesh>* meshes = new std::map<std::string, SharedMesh>();
+        return *meshes;
+    }
+
+    bool RegistryEnabled = false;       // Sharing is opt-in (see GlGeomRegistry.h)
+}
+
+void GlGeomRegistry::SetEnabled(bool enabled)
+{
+    RegistryEnabled = enabled;
+}
+
+bool GlGeomRegistry::IsEnabled()
+{
+    return RegistryEnabled;
+}
+
+bool GlGeomRegistry::Acquire(const std::string& key, unsigned int* vao, unsigned int* vbo, unsigned int* ebo)
+{
+    std::map<std::string, SharedMesh>::iterator it = TheMeshes().find(key);
+    if (it == TheMeshes().end()) {
+        return false;
+    }
+    it->second.refCount++;
+    *vao = it->second.vao;
+    *vbo = it->second.vbo;
+    *ebo = it->second.ebo;
+    return true;
+}
+
+void GlGeomRegistry::Register(const std::string& key, unsigned int vao, unsigned int vbo, unsigned int ebo,
+    long long numBytes)
+{
+    assert(TheMeshes().find(key) == TheMeshes().end() && "Mesh is already registered");
+    SharedMesh& mesh = TheMeshes()[key];
+    mesh.vao = vao;
+    mesh.vbo = vbo;
+    mesh.ebo = ebo;
+    mesh.refCount = 1;
+    if (GlGeomBudget::Default() != nullptr) {
+        GlGeomBudget::Default()->RecordAllocation(&mesh, numBytes);
+    }
+}
+
+void GlGeomRegistry::Release(const std::string& key)
+{
+    std::map<std::string, SharedMesh>::iterator it = TheMeshes().find(key);
+    if (it == TheMeshes().end()) {
+        assert(false && "Releasing a mesh that is not registered");
+        return;
+    }
+    if (--(it->second.refCount) > 0) {
+        return;
+    }
+    GlGeomStateCache::DeleteVertexArray(it->second.vao);
+    glDeleteBuffers(1, &it->second.vbo);
+    glDeleteBuffers(1, &it->second.ebo);
+    if (GlGeomBudget::Default() != nullptr) {
+        GlGeomBudget::Default()->RecordRelease(&it->second);
+    }
+    TheMeshes().erase(it);
+}
+
+int GlGeomRegistry::GetNumMeshes()
+{
+    return (int)TheMeshes().size();
+}
+
+int GlGeomRegistry::GetNumReferences(const std::string& key)
+{
+    std::map<std::string, SharedMesh>::const_iterator it = TheMeshes().find(key);
+    return (it == TheMeshes().end()) ? 0 : it->second.refCount;
+}
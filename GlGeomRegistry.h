@@ -0,0 +1,68 @@
+/*
+* GlGeomRegistry.h - Version 0.9 - October 18, 2026
+*
+* Registry of shared VAO/VBO/EBO's for the GlGeomShape classes.
+*   GlGeomShape objects with the same shape parameters (e.g. the
+*   same numbers of slices and stacks), the same attribute locations
+*   and the same vertex format share one VAO, VBO and EBO.
+*   The mesh is calculated only by the first of them, and the
+*   OpenGL objects are deleted when the last of them is destroyed
+*   or re-meshed.
+*
+* Sharing is off by default.  Call GlGeomRegistry::SetEnabled(true) before
+*   InitializeAttribLocations to share meshes. The registry is then used
+*   automatically by GlGeomBase::InitializeAttribLocations.
+*
+* The trade-off: A shared mesh saves memory and calculation for many identical
+*   shapes, but is never changed in place, since other shapes may be using it.
+*   Re-meshing a shared shape (even when only the vertices change, like the
+*   minor radius of a torus) moves it to the shared mesh for its new key,
+*   calculating that mesh in new buffers if no other shape has it.
+*   So the in place updates of re-meshing (buffers reused when large enough,
+*   vertex only updates) are only done for unshared shapes. Shared meshes are
+*   also not evicted by a GlGeomBudget, and not loaded by a GlGeomLoader.
+*   Enable sharing for many identical shapes which are rarely re-meshed.
+*
+* An addition to the software accompanying POSSIBLE SECOND EDITION TO the book
+*		3D Computer Graphics: A Mathematical Introduction with OpenGL,
+*		by S. Buss, Cambridge University Press, 2003.
+*   Not part of the book's software, and not written by its author.
+*
+* Software is "as-is" and carries no warranty.  It may be used without
+*   restriction, but if you modify it, please change the filenames to
+*   prevent confusion between different versions.
+* Web page of the book's software: http://math.ucsd.edu/~sbuss/MathCG2
+*/
+
+#pragma once
+#ifndef GLGEOM_REGISTRY_H
+#define GLGEOM_REGISTRY_H
+
+#include <string>
+
+class GlGeomRegistry
+{
+public:
+    static void SetEnabled(bool enabled);
+    static bool IsEnabled();
+
+    // Acquire(): If a mesh with this key is registered, returns true and the
+    //    VAO, VBO and EBO, and adds a reference.  Otherwise returns false.
+    static bool Acquire(const std::string& key, unsigned int* vao, unsigned int* vbo, unsigned int* ebo);
+
+    // Register(): Add a newly calculated mesh, with one reference.
+    //    The registry takes ownership of the VAO, VBO and EBO.
+    //    numBytes is the size of the VBO and EBO, for the budget (see GlGeomBudget.h).
+    static void Register(const std::string& key, unsigned int vao, unsigned int vbo, unsigned int ebo,
+        long long numBytes = 0);
+
+    // Release(): Drop one reference. When the last reference is dropped,
+    //    the VAO, VBO and EBO are deleted.
+    static void Release(const std::string& key);
+
+    // Statistics
+    static int GetNumMeshes();                          // Number of distinct shared meshes
+    static int GetNumReferences(const std::string& key);    // 0 if not registered
+};
+
+#endif  // GLGEOM_REGISTRY_H
@@ -25,10 +25,13 @@
 #include <GLFW/glfw3.h>
 
 #include "LinearR3.h"
+#include "LinearR4.h"
 #include "MathMisc.h"
 #include "assert.h"
+#include <stdio.h>
 
 #include "GlGeomSphere.h"
+#include "GlGeomParametric.h"
 
 void GlGeomSphere::Remesh(int slices, int stacks)
 {
@@ -38,82 +41,43 @@ void GlGeomSphere::Remesh(int slices, int stacks)
 
     numSlices = ClampRange(slices, 3, 255);
     numStacks = ClampRange(stacks, 3, 255);
+    SetMeshDirty();
 }
 
+std::string GlGeomSphere::GetShapeKey() const
+{
+    char key[48];
+    snprintf(key, sizeof(key), "GlGeomSphere %d %d", numSlices, numStacks);
+    return std::string(key);
+}
+
+// The unit sphere, as a parametric surface (see GlGeomParametric.h).
+//    theta (u) measures from the (negative-z)-axis, going counterclockwise viewed from above.
+//    phi (v) measures from the (negative-y)-axis, the south pole.
+struct GlGeomSphereSurface {
+    static const bool Poles = true;
+    void EvalRow(float costheta, float sintheta, int n, const float* cosphi, const float* sinphi,
+        GlGeomParametricRow row) const
+    {
+        for (int j = 0; j < n; j++) {
+            row.x[j] = -sintheta * sinphi[j];
+            row.y[j] = -cosphi[j];
+            row.z[j] = -costheta * sinphi[j];
+            row.nx[j] = row.x[j];
+            row.ny[j] = row.y[j];
+            row.nz[j] = row.z[j];
+        }
+    }
+};
+
 // Create the VBO and EBO data for the sphere.
 // See GlGeomBase.h for more information.
-// This routine could be adapted for stand-alone use, as is.
 void GlGeomSphere::CalcVboAndEbo(float* VBOdataBuffer, unsigned int* EBOdataBuffer,
     int vertPosOffset, int vertNormalOffset, int vertTexCoordsOffset, unsigned int stride)
 {
     assert(vertPosOffset >= 0 && stride>0);
-    bool calcNormals = (vertNormalOffset >= 0);       // Should normals be calculated?
-    bool calcTexCoords = (vertTexCoordsOffset >= 0);  // Should texture coordinates be calculated?
-
-     for (int i = 0; i <= numSlices; i++) {
-        // Handle a slice of vertices.
-        // theta measures from the (negative-z)-axis, going counterclockwise viewed from above.
-        float theta = ((float)(i%numSlices))*(float)PI2 / (float)(numSlices);
-        float sTexCd = ((float)i) / (float)numSlices;     // s texture coordinate
-        float costheta = cos(theta);
-        float sintheta = sinf(theta);
-        for (int j = 0; j <= numStacks; j++) {
-            unsigned int vertNumber;
-            if (!GetVertexNumber(i, j, calcTexCoords, &vertNumber)) {
-                continue;       // North or South pole -- duplicate not needed
-            }
-            // phi measures from the (postive-y)-axis
-            float tTexCd = ((float)j) / (float)(numStacks); // t texture coordinate
-            float phi = tTexCd * (float)PI;
-            float cosphi = cosf(phi);
-            float sinphi = (j < numStacks) ? sinf(phi) : 0.0f;
-            float x = -sintheta*sinphi;       // Position, x coordinate            
-            float y = -cosphi;                // Position, y coordinate
-            float z = -costheta*sinphi;       // Position, z coordinate
-            float* basePtr = VBOdataBuffer + stride*vertNumber;
-            float* vPtr = basePtr + vertPosOffset;
-            *vPtr = x;
-            *(vPtr + 1) = y;
-            *(vPtr + 2) = z;
-            if (calcNormals) {
-                float* nPtr = basePtr + vertNormalOffset;
-                *nPtr = x;
-                *(nPtr + 1) = y;
-                *(nPtr + 2) = z;
-            }
-            if (calcTexCoords) {
-                float* tcPtr = basePtr + vertTexCoordsOffset;
-                *tcPtr = (j != 0 && j != numStacks) ? sTexCd : 0.5f;  // s=0.5 at the poles
-                *(tcPtr + 1) = tTexCd;
-            }
-        }
-     }
-     
-     // Calculate elements (vertex indices) suitable for putting into an EBO
-     //      in GL_TRIANGLES mode.
-     unsigned int* toEbo = EBOdataBuffer;
-     for (int i = 0; i < numSlices; i++) {
-         // Handle a slice of vertices.
-         unsigned int leftIdxOld, rightIdxOld;
-         GetVertexNumber(i, 0, calcTexCoords, &leftIdxOld);
-         GetVertexNumber(i + 1, 1, calcTexCoords, &rightIdxOld);
-         for (int j = 0; j < numStacks-1; j++) {
-             unsigned int leftIdxNew, rightIdxNew;
-             GetVertexNumber(i, j + 1, calcTexCoords, &leftIdxNew);
-             GetVertexNumber(i + 1, j + 2, calcTexCoords, &rightIdxNew);
-             *(toEbo++) = leftIdxOld;
-             *(toEbo++) = rightIdxOld;
-             *(toEbo++) = leftIdxNew;
-
-             *(toEbo++) = leftIdxNew;
-             *(toEbo++) = rightIdxOld;
-             *(toEbo++) = rightIdxNew;
-
-             leftIdxOld = leftIdxNew;
-             rightIdxOld = rightIdxNew;
-         }
-     }
-     assert(toEbo - EBOdataBuffer == GetNumElements());
+    GlGeomParametricCalc(GlGeomSphereSurface(), numSlices, numStacks, VBOdataBuffer, EBOdataBuffer,
+        vertPosOffset, vertNormalOffset, vertTexCoordsOffset, stride);
 }
 
 // Calculate the vertex number for the vertex on slice i and stack j.
@@ -143,16 +107,6 @@ void GlGeomSphere::InitializeAttribLocations(
     GlGeomBase::InitializeAttribLocations(pos_loc, normal_loc, texcoords_loc);
 }
 
-bool GlGeomSphere::PreRender() {
-    GlGeomBase::PreRender();
-    if (loadedSlices != numSlices || loadedStacks != numStacks) {
-        GlGeomBase::ReInitializeAttribLocations();
-        loadedSlices = numSlices;
-        loadedStacks = numStacks;
-    }
-    return true;
-}
-
 // **********************************************
 // This routine does the rendering.
 // If the sphere's VBO and EBO data need to be calculated, it does this first.
@@ -179,9 +133,7 @@ void GlGeomSphere::RenderSlice(int i)
 // **********************************************
 // This routine renders a single horizontal stack as a triangle strip.
 // If the sphere's VBO and EBO data need to be calculated, it does this first.
-//   Not efficient for reuse: Recalculates the EBO data every time.
-//   Generates a new EBO everytime
-//  j can range from 0 to numStacks. At the two extremes the bottom and top
+//  j can range from 0 to numStacks-1. At the two extremes the bottom and top
 //     fans are rendered as triangle strips with degenerate triangles.
 // **********************************************
 void GlGeomSphere::RenderStack(int j)
@@ -189,42 +141,155 @@ void GlGeomSphere::RenderStack(int j)
     assert(j >= 0 && j < numStacks);
     PreRender();
 
-    // Create the EBO (element buffer data) for the i-th slice as a triangle strip.
-    unsigned int* stackElts = new unsigned int[(numSlices + 1) * 2];
-    unsigned int* toElt = stackElts;
-    for (int i = 0; i <= numSlices; i++) {
-        GetVertexNumber(i, j+1, UseTexCoords(), toElt++);
-        GetVertexNumber(i, j, UseTexCoords(), toElt++);
-    }
-
-    // Render the triangle strip
-    GlGeomBase::RenderElements(GL_TRIANGLE_STRIP, (numSlices + 1) * 2, stackElts);
-
+    int stripLen = GetNumElementsInStackStrip();
+    GlGeomBase::RenderEBO(GL_TRIANGLE_STRIP, stripLen, GetNumElements() + j*stripLen);
 }
 
 // **********************************************
-// This routine renders the triangle fan around the North Pole.
+// These routines render the triangle fans around the North Pole and the South Pole.
 // If the sphere's VBO and EBO data need to be calculated, it does this first.
-//   Not efficient for reuse: Recalculates the EBO data every time.
-//   Generates a new EBO everytime
 // **********************************************
 void GlGeomSphere::RenderNorthPoleFan() {
     PreRender();
 
-    // Create the EBO (element buffer data) for the north pole as a triangle fan
-    unsigned int* poleElts = new unsigned int[numSlices + 2];
-    unsigned int* toElt = poleElts;
-    GetVertexNumber( 0, numStacks, UseTexCoords(), toElt++ ); // North pole is the center of the triangle fan
-    for (int i = 0; i <= numSlices; i++) {
-        GetVertexNumber(i, numStacks - 1, UseTexCoords(), toElt++);
-    }
+    int fanStart = GetNumElements() + numStacks * GetNumElementsInStackStrip();
+    GlGeomBase::RenderEBO(GL_TRIANGLE_FAN, GetNumElementsInPoleFan(), fanStart);
+}
+
+void GlGeomSphere::RenderSouthPoleFan() {
+    PreRender();
 
-    // Render the triangle fan
-    GlGeomBase::RenderElements(GL_TRIANGLE_FAN, numSlices + 2, poleElts);
+    int fanStart = GetNumElements() + numStacks * GetNumElementsInStackStrip() + GetNumElementsInPoleFan();
+    GlGeomBase::RenderEBO(GL_TRIANGLE_FAN, GetNumElementsInPoleFan(), fanStart);
 }
 
+// **********************************************
+// This routine renders the part of the sphere facing the viewer.
+// If the sphere's VBO and EBO data need to be calculated, it does this first.
+// **********************************************
+int GlGeomSphere::RenderVisible(const LinearMapR4& modelview, const LinearMapR4& projection)
+{
+    PreRender();
+    int numElts = CalcVisibleRanges(numSlices, numStacks, modelview, projection, 0, visibleCounts, visibleStarts);
+    RenderEBORanges(GL_TRIANGLES, (int)visibleCounts.size(), visibleCounts.data(), visibleStarts.data());
+    return numElts / 3;
+}
+
+// The visible cap is found in the sphere's model coordinates, where it is the
+//    unit sphere. (The modelview matrix may scale the sphere to an ellipsoid: this
+//    does not change which triangles face the viewer.)
+// From an eye at distance d from the center, a point p on the sphere is on the
+//    horizon when angle(p, eye) = acos(1/d).  A triangle is not a point on the
+//    sphere: if its vertices are within angle beta of its normal, it may face the
+//    viewer only if a vertex is within acos(cos(beta)/d) + beta of the eye direction.
+//    beta is bounded by the diagonal of a slice/stack cell.
+// A triangle is rendered if any of its vertices is within this angle.
+// Orthographic projections have the eye at infinity, with angle 90 + beta.
+int GlGeomSphere::CalcVisibleRanges(int slices, int stacks,
+    const LinearMapR4& modelview, const LinearMapR4& projection,
+    int firstElement, std::vector<int>& counts, std::vector<int>& starts)
+{
+    counts.clear();
+    starts.clear();
+    int sliceLen = 6 * (stacks - 1);
+    LinearMapR4 inv = modelview.Inverse();
+    double beta = sqrt(Square(PI2 / (double)slices) + Square(PI / (double)stacks));
+    VectorR3 eyeDir;
+    double capAngle;
+    if (projection.m43 == 0.0) {
+        eyeDir.Set(inv.m13, inv.m23, inv.m33);     // Toward the viewer (the +z axis)
+        eyeDir.Normalize();
+        capAngle = 0.5*PI + beta;
+    }
+    else {
+        eyeDir.Set(inv.m14, inv.m24, inv.m34);     // The eye position
+        double dist = eyeDir.Norm();
+        capAngle = (dist > 1.0) ? acos(cos(beta) / dist) + beta : PI;
+        if (capAngle < PI) {
+            eyeDir /= dist;
+        }
+    }
+    if (capAngle >= PI) {
+        counts.push_back(slices * sliceLen);     // Render everything
+        starts.push_back(firstElement);
+        return counts.back();
+    }
+    double cosCap = cos(capAngle);
 
+    // Vertex (i,j) is at (-sin(theta)sin(phi), -cos(phi), -cos(theta)sin(phi)).
+    //    It is in the cap if  -sin(phi)*a_i - cos(phi)*eyeDir.y > cosCap,
+    //    where a_i = sin(theta)*eyeDir.x + cos(theta)*eyeDir.z.
+    std::vector<double> sinCosPhi(2 * (stacks + 1));
+    for (int j = 0; j <= stacks; j++) {
+        double phi = (double)j*PI / (double)stacks;
+        sinCosPhi[2 * j] = (j < stacks) ? sin(phi) : 0.0;
+        sinCosPhi[2 * j + 1] = cos(phi);
+    }
+    std::vector<char> inCap(2 * (stacks + 1));
+    char* leftIn = inCap.data();
+    char* rightIn = leftIn + (stacks + 1);
+    for (int i = 0; i <= slices; i++) {
+        double theta = (double)(i%slices)*PI2 / (double)slices;
+        double a = sin(theta)*eyeDir.x + cos(theta)*eyeDir.z;
+        for (int j = 0; j <= stacks; j++) {
+            rightIn[j] = (-sinCosPhi[2 * j] * a - sinCosPhi[2 * j + 1] * eyeDir.y > cosCap) ? 1 : 0;
+        }
+        if (i > 0) {
+            // The triangles of slice i-1, as ordered by CalcVboAndEbo()
+            int sliceStart = firstElement + (i - 1)*sliceLen;
+            for (int j = 0; j < stacks - 1; j++) {
+                bool vis[2];
+                vis[0] = leftIn[j] || rightIn[j + 1] || leftIn[j + 1];
+                vis[1] = leftIn[j + 1] || rightIn[j + 1] || rightIn[j + 2];
+                for (int t = 0; t < 2; t++) {
+                    if (!vis[t]) {
+                        continue;
+                    }
+                    int start = sliceStart + 6 * j + 3 * t;
+                    if (!counts.empty() && starts.back() + counts.back() == start) {
+                        counts.back() += 3;
+                    }
+                    else {
+                        starts.push_back(start);
+                        counts.push_back(3);
+                    }
+                }
+            }
+        }
+        char* temp = leftIn;
+        leftIn = rightIn;
+        rightIn = temp;
+    }
 
+    int numElts = 0;
+    for (int c : counts) {
+        numElts += c;
+    }
+    return numElts;
+}
 
+// Calculate the elements for the stack triangle strips and the pole triangle fans.
+//   These are placed in the EBO after the elements for GL_TRIANGLES.
+void GlGeomSphere::CalcSubRangeElements(unsigned int* EBOdataBuffer, bool calcTexCoords)
+{
+    unsigned int* toElt = EBOdataBuffer;
+    for (int j = 0; j < numStacks; j++) {
+        for (int i = 0; i <= numSlices; i++) {
+            GetVertexNumber(i, j + 1, calcTexCoords, toElt++);
+            GetVertexNumber(i, j, calcTexCoords, toElt++);
+        }
+    }
 
+    // North pole is the center of the triangle fan
+    GetVertexNumber(0, numStacks, calcTexCoords, toElt++);
+    for (int i = 0; i <= numSlices; i++) {
+        GetVertexNumber(i, numStacks - 1, calcTexCoords, toElt++);
+    }
 
+    // South pole: same orientation as the north pole fan, so goes around in the opposite direction
+    GetVertexNumber(0, 0, calcTexCoords, toElt++);
+    for (int i = numSlices; i >= 0; i--) {
+        GetVertexNumber(i, 1, calcTexCoords, toElt++);
+    }
+    assert(toElt - EBOdataBuffer == GetNumSubRangeElements());
+}
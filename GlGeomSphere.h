@@ -24,6 +24,7 @@
 #define GLGEOM_SPHERE_H
 
 #include "GlGeomBase.h"
+#include <assert.h>
 
 // GlGeomSphere
 //     Generates vertices, normals, and texture coordinates for a sphere.
@@ -73,9 +74,35 @@ public:
     // Selectively render a slice or a stack or a north pole triangle fan
     // Slice numbers i rangle from 0 to numSlices-1.
     // Stack numbers j are allowed to range from 1 to numStacks-2.
+    // The triangle strips and fans are stored in the EBO after the triangles,
+    //    so these are all single draw calls from the EBO.
     void RenderSlice(int i);    // Renders the i-th slice as triangles
     void RenderStack(int j);    // Renders the j-th stack as a triangle strip
     void RenderNorthPoleFan();  // Renders the north pole stack as a triangle fan.
+    void RenderSouthPoleFan();  // Renders the south pole stack as a triangle fan.
+
+    // RenderVisible(): Render only the triangles on the part of the sphere which
+    //    faces the viewer (the cap inside the horizon), skipping the far side.
+    //    modelview and projection are the matrices loaded into the shader.
+    //    The visible stacks of each slice are a range of the EBO; the ranges
+    //    are merged where they touch and drawn with one glMultiDrawElements.
+    //    Returns the number of triangles rendered.
+    int RenderVisible(const LinearMapR4& modelview, const LinearMapR4& projection);
+
+    // CalcVisibleRanges(): The ranges of GL_TRIANGLES elements rendered by RenderVisible(),
+    //    for a sphere with the given slices and stacks whose elements start at firstElement.
+    //    Returns the total number of elements in the ranges.
+    static int CalcVisibleRanges(int slices, int stacks,
+        const LinearMapR4& modelview, const LinearMapR4& projection,
+        int firstElement, std::vector<int>& counts, std::vector<int>& starts);
+
+    // SetConstMesh(): Use the mesh generated at compile time, instead of calculating it.
+    //    Its slices and stacks must be the same as the sphere's. See GlGeomConstMesh.h.
+    template<int Slices, int Stacks, GlGeomConstLayout Layout>
+    void SetConstMesh(const ConstSphereMesh<Slices, Stacks, Layout>& mesh) {
+        assert(Slices == numSlices && Stacks == numStacks);
+        SetConstMeshData(mesh.GetData());
+    }
 
     int GetNumSlices() const { return numSlices; }
     int GetNumStacks() const { return numStacks; }
@@ -93,33 +120,50 @@ public:
     int GetNumTrianglesInStack() const { return 2 * numSlices; }
     int GetNumTriangles() const { return 2 * numSlices*(numStacks - 1); }
 
+    // Extra elements in the EBO: a triangle strip for each stack, then the two pole fans.
+    int GetNumElementsInStackStrip() const { return 2 * (numSlices + 1); }
+    int GetNumElementsInPoleFan() const { return numSlices + 2; }
+    int GetNumSubRangeElements() const {
+        return numStacks * GetNumElementsInStackStrip() + 2 * GetNumElementsInPoleFan();
+    }
+
+    // The unit sphere: normals equal positions, and it fits in the unit cube.
+    //    This allows the compact vertex formats (see GlGeomVertexFormat.h).
+    bool NormalsEqualPositions() const { return true; }
+    bool FitsUnitCube() const { return true; }
+
+    // Spheres with the same numbers of slices and stacks share their VAO, VBO and EBO.
+    std::string GetShapeKey() const;
+
+    // Can be moved (e.g., kept in a std::vector), but not copied.
+    GlGeomSphere(GlGeomSphere&&) = default;
+    GlGeomSphere& operator=(GlGeomSphere&&) = default;
+
 private:
+    friend class GlGeomSphereLOD;       // Calculates its levels with CalcVboAndEbo()
 
     // CalcVboAndEbo- return all VBO vertex information, and EBO elements for GL_TRIANGLES drawing.
     // See GlGeomBase.h for additional information
     void CalcVboAndEbo(float* VBOdataBuffer, unsigned int* EBOdataBuffer,
         int vertPosOffset, int vertNormalOffset, int vertTexCoordsOffset,
         unsigned int stride);
+    void CalcSubRangeElements(unsigned int* EBOdataBuffer, bool calcTexCoords);
 
-	// Disable all copy and assignment operators.
-	// A GlGeomSphere can be allocated as a global or static variable, or with new.
+	// Disable the copy constructor and copy assignment (moving is allowed, see above).
+	// A GlGeomSphere can be allocated as a global or static variable, with new, or in a std::vector.
     //     If you need to pass it to/from a function, use references or pointers
     //     and be sure that there are no implicit copy or assignment operations!
     GlGeomSphere(const GlGeomSphere&) = delete;
 	GlGeomSphere& operator=(const GlGeomSphere&) = delete;
-	GlGeomSphere(GlGeomSphere&&) = delete;
-	GlGeomSphere& operator=(GlGeomSphere&&) = delete;
 
 private:
     int numSlices;              // Number of radial slices
     int numStacks;              // Number of levels separating the north pole from the south pole.
-
-    int loadedSlices = 0;           // Number of slices stored in VBO/EBO
-    int loadedStacks = 0;           // Number of stacks stored in VBO/EBO
+    std::vector<int> visibleCounts;     // Ranges used by RenderVisible()
+    std::vector<int> visibleStarts;
 
 private:
     bool GetVertexNumber(int i, int j, bool calcTexCoords, unsigned int* retVertNum);
-    bool PreRender();
 };
 
 // Constructor
@@ -127,8 +171,6 @@ inline GlGeomSphere::GlGeomSphere(int slices, int stacks)
 {
 	numSlices = slices;
 	numStacks = stacks;
-    loadedSlices = 0;
-    loadedStacks = 0;
 }
 
 #endif  // GLGEOM_SPHERE_H
@@ -0,0 +1,173 @@
+/*
+* GlGeomSphereLOD.cpp - Version 0.9 - October 18, 2026
+*
+* C++ class for rendering spheres at several levels of detail in Modern OpenGL.
+*    See GlGeomSphereLOD.h for more information.
+*
+* An addition to the software accompanying POSSIBLE SECOND EDITION TO the book
+*		3D Computer Graphics: A Mathematical Introduction with OpenGL,
+*		by S. Buss, Cambridge University Press, 2003.
+*   Not part of the book's software, and not written by its author.
+*
+* Software is "as-is" and carries no warranty.  It may be used without
+*   restriction, but if you modify it, please change the filenames to
+*   prevent confusion between different versions.
+* Web page of the book's software: http://math.ucsd.edu/~sbuss/MathCG2
+*/
+
+// Use the static library (so glew32.dll is not needed):
+#define GLEW_STATIC
+#include <GL/glew.h>
+#include <GLFW/glfw3.h>
+
+#include "MathMisc.h"
+#include "assert.h"
+#include <stdio.h>
+
+#include "GlGeomSphereLOD.h"
+#include "GlGeomSphere.h"
+
+// Needed since MaxLevels is passed by reference (to ClampRange).
+const int GlGeomSphereLOD::MaxLevels;
+
+GlGeomSphereLOD::GlGeomSphereLOD(int levels, int baseSlices, int baseStacks)
+{
+    numLevels = 0;
+    Remesh(levels, baseSlices, baseStacks);
+}
+
+void GlGeomSphereLOD::Remesh(int levels, int baseSlices, int baseStacks)
+{
+    levels = ClampRange(levels, 1, MaxLevels);
+    int slices = ClampRange(baseSlices, 3, 255);
+    int stacks = ClampRange(baseStacks, 3, 255);
+    if (levels == numLevels && slices == levelSlices[0] && stacks == levelStacks[0]) {
+        return;
+    }
+    numLevels = levels;
+    for (int i = 0; i < numLevels; i++) {
+        levelSlices[i] = slices;
+        levelStacks[i] = stacks;
+        slices = Min(2 * slices, 255);
+        stacks = Min(2 * stacks, 255);
+    }
+    SetMeshDirty();
+}
+
+std::string GlGeomSphereLOD::GetShapeKey() const
+{
+    char key[48];
+    snprintf(key, sizeof(key), "GlGeomSphereLOD %d %d %d", numLevels, levelSlices[0], levelStacks[0]);
+    return std::string(key);
+}
+
+int GlGeomSphereLOD::GetLevelFirstElement(int level) const
+{
+    int first = 0;
+    for (int i = 0; i < level; i++) {
+        first += GetLevelNumElements(i);
+    }
+    return first;
+}
+
+int GlGeomSphereLOD::GetNumElements() const
+{
+    return GetLevelFirstElement(numLevels);
+}
+
+int GlGeomSphereLOD::GetNumVerticesTexCoords() const
+{
+    int num = 0;
+    for (int i = 0; i < numLevels; i++) {
+        num += (levelSlices[i] + 1)*(levelStacks[i] - 1) + 2;
+    }
+    return num;
+}
+
+int GlGeomSphereLOD::GetNumVerticesNoTexCoords() const
+{
+    int num = 0;
+    for (int i = 0; i < numLevels; i++) {
+        num += levelSlices[i] * (levelStacks[i] - 1) + 2;
+    }
+    return num;
+}
+
+// Create the VBO and EBO data for all the levels.
+//    Each level is calculated by a GlGeomSphere, then its elements are offset
+//    to the level's first vertex.
+void GlGeomSphereLOD::CalcVboAndEbo(float* VBOdataBuffer, unsigned int* EBOdataBuffer,
+    int vertPosOffset, int vertNormalOffset, int vertTexCoordsOffset, unsigned int stride)
+{
+    bool calcTexCoords = (vertTexCoordsOffset >= 0);
+    unsigned int firstVertex = 0;
+    unsigned int* toEbo = EBOdataBuffer;
+    for (int i = 0; i < numLevels; i++) {
+        GlGeomSphere level(levelSlices[i], levelStacks[i]);
+        level.CalcVboAndEbo(VBOdataBuffer + stride*firstVertex, toEbo,
+            vertPosOffset, vertNormalOffset, vertTexCoordsOffset, stride);
+        if (toEbo != nullptr) {
+            int numElts = level.GetNumElements();
+            for (int k = 0; k < numElts; k++) {
+                toEbo[k] += firstVertex;
+            }
+            toEbo += numElts;
+        }
+        firstVertex += calcTexCoords ? level.GetNumVerticesTexCoords() : level.GetNumVerticesNoTexCoords();
+    }
+    assert(toEbo == nullptr || toEbo - EBOdataBuffer == GetNumElements());
+}
+
+void GlGeomSphereLOD::InitializeAttribLocations(
+    unsigned int pos_loc, unsigned int normal_loc, unsigned int texcoords_loc)
+{
+    GlGeomBase::InitializeAttribLocations(pos_loc, normal_loc, texcoords_loc);
+}
+
+// The number of slices needed is the circumference on the screen
+//    divided by the target edge length.
+int GlGeomSphereLOD::SelectLevel(double pixelRadius, GlGeomLodState* state) const
+{
+    double neededSlices = PI2 * pixelRadius / pixelsPerEdge;
+    return GlGeomSelectLevel(levelSlices, numLevels, neededSlices, state);
+}
+
+void GlGeomSphereLOD::Render()
+{
+    RenderLevel(numLevels - 1);
+}
+
+void GlGeomSphereLOD::RenderLevel(int level)
+{
+    assert(level >= 0 && level < numLevels);
+    PreRender();
+    GlGeomBase::RenderEBO(GL_TRIANGLES, GetLevelNumElements(level), GetLevelFirstElement(level));
+}
+
+void GlGeomSphereLOD::RenderLevelInstanced(int level, int count, unsigned int instanceBuffer, int firstInstance)
+{
+    assert(level >= 0 && level < numLevels);
+    PreRender();
+    RenderEBOInstanced(GL_TRIANGLES, GetLevelNumElements(level), GetLevelFirstElement(level),
+        count, instanceBuffer, firstInstance);
+}
+
+int GlGeomSphereLOD::Render(const LinearMapR4& modelview, const LinearMapR4& projection,
+    int viewportHeight, GlGeomLodState* state)
+{
+    double pixelRadius = GlGeomProjectedRadius(modelview, projection, viewportHeight);
+    int level = SelectLevel(pixelRadius, state);
+    if (UsesMeshlets()) {
+        RenderCulled(modelview, projection, level);
+        return level;
+    }
+    if (!renderVisibleOnly) {
+        RenderLevel(level);
+        return level;
+    }
+    PreRender();
+    GlGeomSphere::CalcVisibleRanges(levelSlices[level], levelStacks[level], modelview, projection,
+        GetLevelFirstElement(level), visibleCounts, visibleStarts);
+    RenderEBORanges(GL_TRIANGLES, (int)visibleCounts.size(), visibleCounts.data(), visibleStarts.data());
+    return level;
+}
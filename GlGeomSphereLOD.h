@@ -0,0 +1,145 @@
+/*
+* GlGeomSphereLOD.h - Version 0.9 - October 18, 2026
+*
+* C++ class for rendering spheres at several levels of detail in Modern OpenGL.
+*   A GlGeomSphereLOD holds a chain of sphere meshes of increasing resolution
+*   in a single VAO, VBO and EBO. Each draw renders one of the levels,
+*   chosen from the size of the sphere on the screen.
+*   Distant spheres are drawn with a few dozen triangles, and near spheres
+*   with the full resolution.
+*
+* How to use:
+*     GlGeomSphereLOD Bodies;              // Levels 6x4, 12x8, 24x16, 48x32
+*     GlGeomLodState SunLod, MoonLod;      // One for each object rendered
+*     ...
+*     Bodies.InitializeAttribLocations(pos_loc);
+*     ...
+*     Bodies.Render(sunModelview, projection, viewportHeight, &SunLod);
+*
+* An addition to the software accompanying POSSIBLE SECOND EDITION TO the book
+*		3D Computer Graphics: A Mathematical Introduction with OpenGL,
+*		by S. Buss, Cambridge University Press, 2003.
+*   Not part of the book's software, and not written by its author.
+*
+* Software is "as-is" and carries no warranty.  It may be used without
+*   restriction, but if you modify it, please change the filenames to
+*   prevent confusion between different versions.
+* Web page of the book's software: http://math.ucsd.edu/~sbuss/MathCG2
+*/
+
+#pragma once
+#ifndef GLGEOM_SPHERE_LOD_H
+#define GLGEOM_SPHERE_LOD_H
+
+#include "GlGeomBase.h"
+#include "GlGeomLOD.h"
+
+class LinearMapR4;
+
+// GlGeomSphereLOD
+//     The levels are unit spheres, the same as GlGeomSphere's.
+//     Level 0 is the coarsest. Each level has twice the slices and stacks of the one before.
+//     The vertices of all levels are in the VBO, and the GL_TRIANGLES elements
+//        of all levels are in the EBO, one level after another.
+
+class GlGeomSphereLOD : public GlGeomBase
+{
+public:
+    static const int MaxLevels = 8;
+
+    GlGeomSphereLOD() : GlGeomSphereLOD(4, 6, 4) {}
+    GlGeomSphereLOD(int numLevels, int baseSlices, int baseStacks);
+
+    // Remesh: change the levels. Slices and stacks are clamped to at most 255.
+    void Remesh(int numLevels, int baseSlices, int baseStacks);
+
+    void InitializeAttribLocations(
+        unsigned int pos_loc, unsigned int normal_loc = UINT_MAX, unsigned int texcoords_loc = UINT_MAX);
+
+    // Render(): Render the finest level.
+    // RenderLevel(): Render a given level.
+    // Render(modelview, ...): Select a level from the projected size, and render it.
+    //    modelview - the modelview matrix loaded into the shader for this sphere
+    //    projection - the projection matrix (from Set_glFrustum)
+    //    viewportHeight - in pixels
+    //    state - remembers the level for this object (may be null, for no hysteresis)
+    //    Returns the level rendered.
+    //    The whole level is rendered, unless SetVisibleOnly(true) (see below),
+    //    or meshlets are used (SetUseMeshlets): then the culled meshlets of the level are skipped.
+    void Render();
+    void RenderLevel(int level);
+    // Render with only the positions (see GlGeomBase::RenderPositionOnly()).
+    void RenderPositionOnly() { RenderLevelPositionOnly(numLevels - 1); }
+    void RenderLevelPositionOnly(int level) { GlGeomBase::RenderPositionOnly(level); }
+    int Render(const LinearMapR4& modelview, const LinearMapR4& projection,
+        int viewportHeight, GlGeomLodState* state = nullptr);
+    // Render copies with one draw call (see GlGeomBase::RenderInstanced()).
+    //    All the instances use the same level: sort instances into one range
+    //    of the instance buffer per level, and render each range.
+    void RenderInstanced(int count, unsigned int instanceBuffer, int firstInstance = 0) {
+        RenderLevelInstanced(numLevels - 1, count, instanceBuffer, firstInstance);
+    }
+    void RenderLevelInstanced(int level, int count, unsigned int instanceBuffer, int firstInstance = 0);
+
+    // SelectLevel(): The level to use for a sphere with the given radius on the screen, in pixels.
+    int SelectLevel(double pixelRadius, GlGeomLodState* state = nullptr) const;
+
+    // SetVisibleOnly(): Render(modelview, ...) renders only the triangles facing the viewer
+    //    (see GlGeomSphere::RenderVisible()).  Default false.  Only use this when back faces
+    //    are culled: otherwise the far side of the sphere is visible, e.g. in wireframe mode.
+    void SetVisibleOnly(bool visibleOnly) { renderVisibleOnly = visibleOnly; }
+    bool IsVisibleOnly() const { return renderVisibleOnly; }
+
+    // Target length of a triangle edge on the screen, in pixels (default 16).
+    void SetPixelsPerEdge(double pixels) { pixelsPerEdge = pixels; }
+    double GetPixelsPerEdge() const { return pixelsPerEdge; }
+
+    int GetNumLevels() const { return numLevels; }
+    int GetNumSlices(int level) const { return levelSlices[level]; }
+    int GetNumStacks(int level) const { return levelStacks[level]; }
+    int GetLevelNumElements(int level) const { return 6 * levelSlices[level] * (levelStacks[level] - 1); }
+    int GetLevelFirstElement(int level) const;
+
+    // The levels are the element groups (for meshlets, see GlGeomBase.h).
+    int GetNumElementGroups() const { return numLevels; }
+    void GetElementGroup(int group, int* firstElement, int* numElements) const {
+        *firstElement = GetLevelFirstElement(group);
+        *numElements = GetLevelNumElements(group);
+    }
+
+    // Totals over all the levels.
+    int GetNumElements() const;
+    int GetNumVerticesTexCoords() const;
+    int GetNumVerticesNoTexCoords() const;
+
+    bool NormalsEqualPositions() const { return true; }
+    bool FitsUnitCube() const { return true; }
+
+    // Spheres with the same levels share their VAO, VBO and EBO.
+    std::string GetShapeKey() const;
+
+    // Can be moved (e.g., kept in a std::vector), but not copied.
+    GlGeomSphereLOD(GlGeomSphereLOD&&) = default;
+    GlGeomSphereLOD& operator=(GlGeomSphereLOD&&) = default;
+
+private:
+    // CalcVboAndEbo- return all VBO vertex information, and EBO elements for GL_TRIANGLES drawing.
+    // See GlGeomBase.h for additional information
+    void CalcVboAndEbo(float* VBOdataBuffer, unsigned int* EBOdataBuffer,
+        int vertPosOffset, int vertNormalOffset, int vertTexCoordsOffset,
+        unsigned int stride);
+
+    GlGeomSphereLOD(const GlGeomSphereLOD&) = delete;
+    GlGeomSphereLOD& operator=(const GlGeomSphereLOD&) = delete;
+
+private:
+    int numLevels;
+    int levelSlices[MaxLevels];
+    int levelStacks[MaxLevels];
+    double pixelsPerEdge = 16.0;
+    bool renderVisibleOnly = false;
+    std::vector<int> visibleCounts;     // Ranges of the visible part of a level
+    std::vector<int> visibleStarts;
+};
+
+#endif  // GLGEOM_SPHERE_LOD_H
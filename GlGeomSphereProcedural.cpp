@@ -0,0 +1,163 @@
+/*
+* GlGeomSphereProcedural.cpp - Version 0.9 - October 18, 2026
+*
+* C++ class for rendering spheres in Modern OpenGL with no VBO or EBO.
+*    See GlGeomSphereProcedural.h for more information.
+*
+* An addition to the software accompanying POSSIBLE SECOND EDITION TO the book
+*		3D Computer Graphics: A Mathematical Introduction with OpenGL,
+*		by S. Buss, Cambridge University Press, 2003.
+*   Not part of the book's software, and not written by its author.
+*
+* Software is "as-is" and carries no warranty.  It may be used without
+*   restriction, but if you modify it, please change the filenames to
+*   prevent confusion between different versions.
+* Web page of the book's software: http://math.ucsd.edu/~sbuss/MathCG2
+*/
+
+// Use the static library (so glew32.dll is not needed):
+#define GLEW_STATIC
+#include <GL/glew.h>
+#include <GLFW/glfw3.h>
+
+#include "GlGeomSphereProcedural.h"
+#include "GlGeomStateCache.h"
+#include "MathMisc.h"
+#include "assert.h"
+#include <utility>
+
+const char* const GlGeomSphereProcedural::UniformName = "sphereSlicesStacks";
+
+// The six vertices of a group are the corners (di,dj) = (0,0), (1,0), (1,1) and
+//    (0,0), (1,1), (0,1) of the cell from slice i to i+1 and stack row to row+1.
+//    At a pole, one of the two triangles of a cell has zero area. So group 0 of a slice
+//    has the second triangle of the south pole cell, then the first of the north pole cell.
+// As in GlGeomSphere, theta starts at the negative z-axis, and the poles have s = 0.5.
+static const char* SphereVertexSource =
+"uniform ivec2 sphereSlicesStacks;       // Set by GlGeomSphereProcedural::Render()\n"
+"void SphereVertex(int vertexID, out vec3 pos, out vec2 texCoords)\n"
+"{\n"
+"   int slices = sphereSlicesStacks.x;\n"
+"   int stacks = sphereSlicesStacks.y;\n"
+"   int group = vertexID / 6;\n"
+"   int corner = vertexID - 6 * group;\n"
+"   int i = group / (stacks - 1);\n"
+"   int row = group - i * (stacks - 1);\n"
+"   if (row == 0) {\n"
+"       if (corner < 3) {\n"
+"           corner += 3;            // South pole\n"
+"       }\n"
+"       else {\n"
+"           corner -= 3;            // North pole\n"
+"           row = stacks - 1;\n"
+"       }\n"
+"   }\n"
+"   int ii = i + ((corner == 1 || corner == 2 || corner == 4) ? 1 : 0);\n"
+"   int j = row + ((corner == 2 || corner == 4 || corner == 5) ? 1 : 0);\n"
+"   float theta = float(ii) * (6.2831853 / float(slices));\n"
+"   float phi = float(j) * (3.1415927 / float(stacks));\n"
+"   float sinPhi = (j == stacks) ? 0.0 : sin(phi);\n"
+"   pos = vec3(-sin(theta) * sinPhi, -cos(phi), -cos(theta) * sinPhi);\n"
+"   bool isPole = (j == 0 || j == stacks);\n"
+"   texCoords = vec2(isPole ? 0.5 : float(ii) / float(slices), float(j) / float(stacks));\n"
+"}\n";
+
+GlGeomSphereProcedural::GlGeomSphereProcedural(int slices, int stacks)
+{
+    numSlices = 0;
+    numStacks = 0;
+    Remesh(slices, stacks);
+}
+
+GlGeomSphereProcedural::~GlGeomSphereProcedural()
+{
+    if (theVAO != 0) {
+        GlGeomStateCache::DeleteVertexArray(theVAO);
+    }
+}
+
+GlGeomSphereProcedural::GlGeomSphereProcedural(GlGeomSphereProcedural&& other) noexcept
+{
+    *this = std::move(other);
+}
+
+GlGeomSphereProcedural& GlGeomSphereProcedural::operator=(GlGeomSphereProcedural&& other) noexcept
+{
+    if (this != &other) {
+        if (theVAO != 0) {
+            GlGeomStateCache::DeleteVertexArray(theVAO);
+        }
+        numSlices = other.numSlices;
+        numStacks = other.numStacks;
+        theVAO = other.theVAO;
+        slicesStacksLoc = other.slicesStacksLoc;
+        instanceMatrixLoc = other.instanceMatrixLoc;
+        instanceColorLoc = other.instanceColorLoc;
+        instanceScaleLoc = other.instanceScaleLoc;
+        other.theVAO = 0;
+    }
+    return *this;
+}
+
+// There is no mesh, so there is nothing to update.
+void GlGeomSphereProcedural::Remesh(int slices, int stacks)
+{
+    numSlices = ClampRange(slices, 3, 4096);
+    numStacks = ClampRange(stacks, 3, 4096);
+}
+
+const char* GlGeomSphereProcedural::GetShaderSource()
+{
+    return SphereVertexSource;
+}
+
+void GlGeomSphereProcedural::InitializeUniformLocation(int slicesStacks_loc)
+{
+    slicesStacksLoc = slicesStacks_loc;
+    if (theVAO == 0) {
+        glGenVertexArrays(1, &theVAO);      // Core profiles need a VAO bound to draw, even with no attributes
+    }
+}
+
+void GlGeomSphereProcedural::SetInstanceAttribLocations(unsigned int matrix_loc, unsigned int color_loc, unsigned int scale_loc)
+{
+    instanceMatrixLoc = matrix_loc;
+    instanceColorLoc = color_loc;
+    instanceScaleLoc = scale_loc;
+}
+
+void GlGeomSphereProcedural::Render()
+{
+    if (theVAO == 0) {
+        assert(false && "InitializeUniformLocation must be called before rendering!");
+    }
+    glUniform2i(slicesStacksLoc, numSlices, numStacks);
+    GlGeomStateCache::BindVertexArray(theVAO);
+    glDrawArrays(GL_TRIANGLES, 0, (GLsizei)GetNumVertices());
+    UnbindVAO();
+}
+
+void GlGeomSphereProcedural::RenderInstanced(int count, unsigned int instanceBuffer, int firstInstance)
+{
+    if (theVAO == 0) {
+        assert(false && "InitializeUniformLocation must be called before rendering!");
+    }
+    if (count <= 0) {
+        return;
+    }
+    glUniform2i(slicesStacksLoc, numSlices, numStacks);
+    GlGeomStateCache::BindVertexArray(theVAO);
+    GlGeomInstanceBuffer::SetAttribPointers(instanceBuffer, firstInstance,
+        instanceMatrixLoc, instanceColorLoc, instanceScaleLoc);
+    glDrawArraysInstanced(GL_TRIANGLES, 0, (GLsizei)GetNumVertices(), (GLsizei)count);
+    GlGeomInstanceBuffer::DisableAttribs(instanceMatrixLoc, instanceColorLoc, instanceScaleLoc);
+    UnbindVAO();
+}
+
+// As in GlGeomBase, the VAO is unbound after rendering, unless the state cache is used.
+void GlGeomSphereProcedural::UnbindVAO() const
+{
+    if (!GlGeomStateCache::IsEnabled()) {
+        GlGeomStateCache::BindVertexArray(0);
+    }
+}
@@ -0,0 +1,119 @@
+/*
+* GlGeomSphereProcedural.h - Version 0.9 - October 18, 2026
+*
+* C++ class for rendering spheres in Modern OpenGL with no VBO or EBO.
+*   The vertex shader calculates each vertex of the sphere from gl_VertexID
+*   and the numbers of slices and stacks (in a uniform).  Rendering is a
+*   glDrawArrays with an empty VAO.  No memory is used for the mesh, and
+*   changing the numbers of slices and stacks (Remesh()) costs nothing:
+*   each draw can use a different resolution.
+*
+* The triangles, positions and texture coordinates are the same as GlGeomSphere's
+*   (the normals equal the positions), but the triangles are not indexed: each
+*   vertex is calculated once for each triangle it is in.
+*
+* How to use:
+*   The vertex shader includes GetShaderSource() after its #version line,
+*   and calls SphereVertex():
+*       "#version 330 core\n"
+*       <GlGeomSphereProcedural::GetShaderSource()>
+*       "uniform mat4 projectionMatrix;\n"
+*       "uniform mat4 modelviewMatrix;\n"
+*       "void main() {\n"
+*       "    vec3 pos;  vec2 texCoords;\n"
+*       "    SphereVertex(gl_VertexID, pos, texCoords);\n"
+*       "    gl_Position = projectionMatrix * modelviewMatrix * vec4(pos, 1.0);\n"
+*       "}\n"
+*   Then:
+*       GlGeomSphereProcedural Sphere(24, 16);
+*       Sphere.InitializeUniformLocation(glGetUniformLocation(program, GlGeomSphereProcedural::UniformName));
+*       ...
+*       Sphere.Render();                // With the program in use
+*   For instanced rendering, the shader reads the instance attributes (see GlGeomInstances.h)
+*   as in vertexShader_Instanced. All the instances of one draw have the same
+*   resolution: render one range of the instance buffer per resolution.
+*
+* An addition to the software accompanying POSSIBLE SECOND EDITION TO the book
+*		3D Computer Graphics: A Mathematical Introduction with OpenGL,
+*		by S. Buss, Cambridge University Press, 2003.
+*   Not part of the book's software, and not written by its author.
+*
+* Software is "as-is" and carries no warranty.  It may be used without
+*   restriction, but if you modify it, please change the filenames to
+*   prevent confusion between different versions.
+* Web page of the book's software: http://math.ucsd.edu/~sbuss/MathCG2
+*/
+
+#pragma once
+#ifndef GLGEOM_SPHERE_PROCEDURAL_H
+#define GLGEOM_SPHERE_PROCEDURAL_H
+
+#include "GlGeomInstances.h"
+#include <limits.h>
+
+// GlGeomSphereProcedural
+//     The unit sphere, centered at the origin, with slices around the y-axis
+//     and stacks from the south pole to the north pole, as for GlGeomSphere.
+//     Vertex number v is in triangle v/3.  The triangles are in groups of two,
+//     six vertices in all, for slice i and stack j (j = 1, ..., stacks-2):
+//        group i*(stacks-1) + j is the two triangles between stacks j and j+1;
+//        group i*(stacks-1) is the two triangles of slice i at the poles.
+
+class GlGeomSphereProcedural
+{
+public:
+    static const char* const UniformName;       // "sphereSlicesStacks", an ivec2
+
+    GlGeomSphereProcedural() : GlGeomSphereProcedural(6, 6) {}
+    GlGeomSphereProcedural(int slices, int stacks);
+    ~GlGeomSphereProcedural();
+
+    // Remesh(): Change the number of slices and stacks. Does no OpenGL work.
+    void Remesh(int slices, int stacks);
+
+    // InitializeUniformLocation(): Creates the empty VAO, and sets the location of
+    //    the UniformName uniform in the shader program.
+    //    This must be called before Render() is first called.
+    void InitializeUniformLocation(int slicesStacks_loc);
+
+    // Render(): Load the slices and stacks into the uniform, and render the
+    //    sphere with glDrawArrays.  The shader program must be in use.
+    void Render();
+
+    // RenderInstanced(): Render count copies with one draw call, as for GlGeomBase::RenderInstanced().
+    void RenderInstanced(int count, unsigned int instanceBuffer, int firstInstance = 0);
+    // The shader locations of the instance attributes (default: see GlGeomInstance).
+    //    Use UINT_MAX for attributes the shader does not have.
+    void SetInstanceAttribLocations(unsigned int matrix_loc, unsigned int color_loc, unsigned int scale_loc);
+
+    int GetNumSlices() const { return numSlices; }
+    int GetNumStacks() const { return numStacks; }
+    int GetNumVertices() const { return 6 * numSlices * (numStacks - 1); }
+    unsigned int GetVAO() const { return theVAO; }
+
+    // GetShaderSource(): GLSL (version 330) declaring the uniform and the function
+    //        void SphereVertex(int vertexID, out vec3 pos, out vec2 texCoords);
+    //    which calculates the position (also the normal) and texture coordinates of a vertex.
+    static const char* GetShaderSource();
+
+    // Can be moved (e.g., kept in a std::vector), but not copied.
+    GlGeomSphereProcedural(GlGeomSphereProcedural&& other) noexcept;
+    GlGeomSphereProcedural& operator=(GlGeomSphereProcedural&& other) noexcept;
+
+private:
+    void UnbindVAO() const;
+
+    GlGeomSphereProcedural(const GlGeomSphereProcedural&) = delete;
+    GlGeomSphereProcedural& operator=(const GlGeomSphereProcedural&) = delete;
+
+private:
+    int numSlices;
+    int numStacks;
+    unsigned int theVAO = 0;            // Empty: the vertices are calculated from gl_VertexID
+    int slicesStacksLoc = -1;
+    unsigned int instanceMatrixLoc = GlGeomInstance::MatrixLoc;
+    unsigned int instanceColorLoc = GlGeomInstance::ColorLoc;
+    unsigned int instanceScaleLoc = GlGeomInstance::ScaleLoc;
+};
+
+#endif  // GLGEOM_SPHERE_PROCEDURAL_H
@@ -0,0 +1,113 @@
+/*
+* GlGeomSpheroid.cpp - Version 0.9 - October 18, 2026
+*
+* C++ class for rendering spheroids in Modern OpenGL.
+*    See GlGeomSpheroid.h for more information.
+*
+* An addition to the software accompanying POSSIBLE SECOND EDITION TO the book
+*		3D Computer Graphics: A Mathematical Introduction with OpenGL,
+*		by S. Buss, Cambridge University Press, 2003.
+*   Not part of the book's software, and not written by its author.
+*
+* Software is "as-is" and carries no warranty.  It may be used without
+*   restriction, but if you modify it, please change the filenames to
+*   prevent confusion between different versions.
+* Web page of the book's software: http://math.ucsd.edu/~sbuss/MathCG2
+*/
+
+// Use the static library (so glew32.dll is not needed):
+#define GLEW_STATIC
+#include <GL/glew.h>
+#include <GLFW/glfw3.h>
+
+#include "MathMisc.h"
+#include "assert.h"
+#include <math.h>
+#include <stdio.h>
+
+#include "GlGeomSpheroid.h"
+#include "GlGeomParametric.h"
+
+GlGeomSpheroid::GlGeomSpheroid(int slices, int stacks, float polar)
+{
+    numSlices = ClampRange(slices, 3, 255);
+    numStacks = ClampRange(stacks, 3, 255);
+    polarRadius = polar;
+}
+
+void GlGeomSpheroid::Remesh(int slices, int stacks, float polar)
+{
+    slices = ClampRange(slices, 3, 255);
+    stacks = ClampRange(stacks, 3, 255);
+    if (slices == numSlices && stacks == numStacks && polar == polarRadius) {
+        return;
+    }
+    bool verticesOnly = (slices == numSlices && stacks == numStacks);
+    numSlices = slices;
+    numStacks = stacks;
+    polarRadius = polar;
+    SetMeshDirty(verticesOnly);
+}
+
+std::string GlGeomSpheroid::GetShapeKey() const
+{
+    char key[64];
+    snprintf(key, sizeof(key), "GlGeomSpheroid %d %d %.9g", numSlices, numStacks, polarRadius);
+    return std::string(key);
+}
+
+// The spheroid, as a parametric surface: the unit sphere, with y scaled by the polar radius.
+//    The normal at (x, y, z) is in the direction (x, y/(polarRadius^2), z).
+//    (gcc vectorizes the square roots only with -fno-math-errno.)
+struct GlGeomSpheroidSurface {
+    static const bool Poles = true;
+    float polarRadius;
+    void EvalRow(float costheta, float sintheta, int n, const float* cosphi, const float* sinphi,
+        GlGeomParametricRow row) const
+    {
+        float b = polarRadius;
+        float invB = 1.0f / polarRadius;
+        for (int j = 0; j < n; j++) {
+            float x = -sintheta * sinphi[j];
+            float z = -costheta * sinphi[j];
+            row.x[j] = x;
+            row.y[j] = -b * cosphi[j];
+            row.z[j] = z;
+            float ny = -invB * cosphi[j];
+            float scale = 1.0f / sqrtf(x*x + ny*ny + z*z);
+            row.nx[j] = x * scale;
+            row.ny[j] = ny * scale;
+            row.nz[j] = z * scale;
+        }
+    }
+};
+
+void GlGeomSpheroid::CalcVboAndEbo(float* VBOdataBuffer, unsigned int* EBOdataBuffer,
+    int vertPosOffset, int vertNormalOffset, int vertTexCoordsOffset, unsigned int stride)
+{
+    assert(vertPosOffset >= 0 && stride > 0);
+    GlGeomSpheroidSurface surface;
+    surface.polarRadius = polarRadius;
+    GlGeomParametricCalc(surface, numSlices, numStacks, VBOdataBuffer, EBOdataBuffer,
+        vertPosOffset, vertNormalOffset, vertTexCoordsOffset, stride);
+}
+
+void GlGeomSpheroid::InitializeAttribLocations(
+    unsigned int pos_loc, unsigned int normal_loc, unsigned int texcoords_loc)
+{
+    GlGeomBase::InitializeAttribLocations(pos_loc, normal_loc, texcoords_loc);
+}
+
+void GlGeomSpheroid::Render()
+{
+    PreRender();
+    GlGeomBase::Render();
+}
+
+void GlGeomSpheroid::RenderSlice(int i)
+{
+    assert(i >= 0 && i < numSlices);
+    PreRender();
+    int sliceLen = GetNumElementsInSlice();
+    GlGeomBase::RenderEBO(GL_TRIANGLES, sliceLen, i*sliceLen);
+}
@@ -0,0 +1,89 @@
+/*
+* GlGeomSpheroid.h - Version 0.9 - October 18, 2026
+*
+* C++ class for rendering spheroids in Modern OpenGL.
+*   A spheroid is a sphere scaled along its polar axis (the y-axis):
+*   the equatorial radius is 1, and the polar radius can be varied.
+*   A polar radius less than 1 gives an oblate spheroid, like the Earth,
+*   or more so, Saturn or Jupiter.  Unlike a sphere scaled by the
+*   modelview matrix, the normals are calculated for the spheroid.
+*   The slices and stacks, the texture coordinates and the order of the
+*   vertices and elements are the same as GlGeomSphere's.
+*   The mesh is generated with GlGeomParametric (see GlGeomParametric.h).
+*
+* An addition to the software accompanying POSSIBLE SECOND EDITION TO the book
+*		3D Computer Graphics: A Mathematical Introduction with OpenGL,
+*		by S. Buss, Cambridge University Press, 2003.
+*   Not part of the book's software, and not written by its author.
+*
+* Software is "as-is" and carries no warranty.  It may be used without
+*   restriction, but if you modify it, please change the filenames to
+*   prevent confusion between different versions.
+* Web page of the book's software: http://math.ucsd.edu/~sbuss/MathCG2
+*/
+
+#pragma once
+#ifndef GLGEOM_SPHEROID_H
+#define GLGEOM_SPHEROID_H
+
+#include "GlGeomBase.h"
+
+// GlGeomSpheroid
+// How to use:
+//     * Call the constructor GlGeomSpheroid() or Remesh() to set the numbers of
+//          slices and stacks, and the polar radius.
+//     * Then call InitializeAttribLocations(), exactly as for GlGeomSphere.
+//     * Call Render() to render the spheroid.
+
+class GlGeomSpheroid : public GlGeomBase
+{
+public:
+    GlGeomSpheroid() : GlGeomSpheroid(6, 6, 0.9f) {}
+    GlGeomSpheroid(int slices, int stacks, float polarRadius);
+
+    // Remesh: change the slices and stacks, and the polar radius.
+    //    If only the polar radius changes, only the vertex data is rewritten.
+    void Remesh(int slices, int stacks) { Remesh(slices, stacks, polarRadius); }
+    void Remesh(int slices, int stacks, float polarRadius);
+
+    void InitializeAttribLocations(
+        unsigned int pos_loc, unsigned int normal_loc = UINT_MAX, unsigned int texcoords_loc = UINT_MAX);
+
+    // Render the spheroid.  Must call InitializeAttribLocations first.
+    void Render();
+    // Render the i-th slice (i = 0,...,numSlices-1).
+    void RenderSlice(int i);
+
+    int GetNumSlices() const { return numSlices; }
+    int GetNumStacks() const { return numStacks; }
+    float GetPolarRadius() const { return polarRadius; }
+    float GetEquatorialRadius() const { return 1.0f; }
+
+    int GetNumElements() const { return 6 * numSlices*(numStacks - 1); }
+    int GetNumVerticesTexCoords() const { return (numSlices + 1)*(numStacks - 1) + 2; }
+    int GetNumVerticesNoTexCoords() const { return numSlices * (numStacks - 1) + 2; }
+    int GetNumElementsInSlice() const { return 6 * (numStacks - 1); }
+
+    bool FitsUnitCube() const { return polarRadius <= 1.0f; }
+
+    std::string GetShapeKey() const;
+
+    // Can be moved (e.g., kept in a std::vector), but not copied.
+    GlGeomSpheroid(GlGeomSpheroid&&) = default;
+    GlGeomSpheroid& operator=(GlGeomSpheroid&&) = default;
+
+private:
+    void CalcVboAndEbo(float* VBOdataBuffer, unsigned int* EBOdataBuffer,
+        int vertPosOffset, int vertNormalOffset, int vertTexCoordsOffset,
+        unsigned int stride);
+
+    GlGeomSpheroid(const GlGeomSpheroid&) = delete;
+    GlGeomSpheroid& operator=(const GlGeomSpheroid&) = delete;
+
+private:
+    int numSlices;
+    int numStacks;
+    float polarRadius;          // Radius along the y-axis (the equatorial radius is 1)
+};
+
+#endif  // GLGEOM_SPHEROID_H
@@ -0,0 +1,167 @@
+/*
+* GlGeomStagingRing.cpp - Version 0.9 - October 18, 2026
+*
+* A persistently mapped staging ring buffer for uploading VBO and EBO data.
+*    See GlGeomStagingRing.h for more information.
+*
+* An addition to the software accompanying POSSIBLE SECOND EDITION TO the book
+*		3D Computer Graphics: A Mathematical Introduction with OpenGL,
+*		by S. Buss, Cambridge University Press, 2003.
+*   Not part of the book's software, and not written by its author.
+*
+* Software is "as-is" and carries no warranty.  It may be used without
+*   restriction, but if you modify it, please change the filenames to
+*   prevent confusion between different versions.
+* Web page of the book's software: http://math.ucsd.edu/~sbuss/MathCG2
+*/
+
+// Use the static library (so glew32.dll is not needed):
+#define GLEW_STATIC
+#include <GL/glew.h>
+#include <GLFW/glfw3.h>
+
+#include "GlGeomStagingRing.h"
+#include "GlGeomBase.h"
+#include "assert.h"
+
+namespace {
+    GlGeomStagingRing* DefaultRing = nullptr;
+    bool RingEnabled = true;
+}
+
+GlGeomStagingRing::GlGeomStagingRing(long long sizeInBytes)
+{
+    ringSize = sizeInBytes;
+    GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+    if (GlGeomBase::UseDSA()) {
+        glCreateBuffers(1, &ringBuffer);
+        glNamedBufferStorage(ringBuffer, (GLsizeiptr)ringSize, 0, flags);
+        mappedPtr = (unsigned char*)glMapNamedBufferRange(ringBuffer, 0, (GLsizeiptr)ringSize, flags);
+        assert(mappedPtr != nullptr);
+        return;
+    }
+    glGenBuffers(1, &ringBuffer);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, ringBuffer);
+    glBufferStorage(GL_COPY_WRITE_BUFFER, (GLsizeiptr)ringSize, 0, flags);
+    mappedPtr = (unsigned char*)glMapBufferRange(GL_COPY_WRITE_BUFFER, 0, (GLsizeiptr)ringSize, flags);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+    assert(mappedPtr != nullptr);
+}
+
+GlGeomStagingRing::~GlGeomStagingRing()
+{
+    while (!fences.empty()) {
+        glDeleteSync((GLsync)fences.front().sync);
+        fences.pop_front();
+    }
+    if (GlGeomBase::UseDSA()) {
+        glUnmapNamedBuffer(ringBuffer);
+    }
+    else {
+        glBindBuffer(GL_COPY_WRITE_BUFFER, ringBuffer);
+        glUnmapBuffer(GL_COPY_WRITE_BUFFER);
+        glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+    }
+    glDeleteBuffers(1, &ringBuffer);
+}
+
+bool GlGeomStagingRing::IsSupported()
+{
+    return GLEW_VERSION_4_4 || GLEW_ARB_buffer_storage;
+}
+
+GlGeomStagingRing* GlGeomStagingRing::Default()
+{
+    if (DefaultRing == nullptr && RingEnabled && IsSupported()) {
+        DefaultRing = new GlGeomStagingRing();
+    }
+    return RingEnabled ? DefaultRing : nullptr;
+}
+
+void GlGeomStagingRing::SetEnabled(bool enabled)
+{
+    RingEnabled = enabled;
+}
+
+void GlGeomStagingRing::DeleteDefault()
+{
+    delete DefaultRing;
+    DefaultRing = nullptr;
+}
+
+void* GlGeomStagingRing::Reserve(long long numBytes, long long* offset)
+{
+    if (numBytes > ringSize) {
+        return nullptr;
+    }
+    long long start = (head + 63) & ~63LL;      // Keep ranges 64 byte aligned
+    if (start + numBytes > ringSize) {
+        start = 0;                              // Wrap around
+    }
+    long long end = start + numBytes;
+
+    // Wait for the GPU to finish with any older ranges that overlap.
+    //    Fences are signaled in order, so wait on all fences up to the newest overlapping one.
+    int lastOverlap = -1;
+    for (int i = 0; i < (int)fences.size(); i++) {
+        if (fences[i].start < end && start < fences[i].end) {
+            lastOverlap = i;
+        }
+    }
+    for (int i = 0; i <= lastOverlap; i++) {
+        WaitForFront();
+    }
+    // Also discard fences that have already been passed (no waiting).
+    while (!fences.empty()) {
+        GLenum status = glClientWaitSync((GLsync)fences.front().sync, 0, 0);
+        if (status != GL_ALREADY_SIGNALED && status != GL_CONDITION_SATISFIED) {
+            break;
+        }
+        glDeleteSync((GLsync)fences.front().sync);
+        fences.pop_front();
+    }
+
+    head = end;
+    *offset = start;
+    return mappedPtr + start;
+}
+
+void GlGeomStagingRing::WaitForFront()
+{
+    GLsync sync = (GLsync)fences.front().sync;
+    GLenum status = glClientWaitSync(sync, 0, 0);
+    if (status != GL_ALREADY_SIGNALED && status != GL_CONDITION_SATISFIED) {
+        numWaits++;
+        do {
+            status = glClientWaitSync(sync, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000000);  // One second
+        } while (status == GL_TIMEOUT_EXPIRED);
+    }
+    glDeleteSync(sync);
+    fences.pop_front();
+}
+
+void GlGeomStagingRing::CopyToBuffer(long long ringOffset, unsigned int dstBuffer, long long dstOffset, long long numBytes)
+{
+    if (numBytes == 0) {
+        return;
+    }
+    if (GlGeomBase::UseDSA()) {
+        glCopyNamedBufferSubData(ringBuffer, dstBuffer, (GLintptr)ringOffset, (GLintptr)dstOffset, (GLsizeiptr)numBytes);
+        return;
+    }
+    glBindBuffer(GL_COPY_READ_BUFFER, ringBuffer);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, dstBuffer);
+    glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER,
+        (GLintptr)ringOffset, (GLintptr)dstOffset, (GLsizeiptr)numBytes);
+    glBindBuffer(GL_COPY_READ_BUFFER, 0);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+}
+
+void GlGeomStagingRing::Fence(long long offset, long long numBytes)
+{
+    FencedRange range;
+    range.start = offset;
+    range.end = offset + numBytes;
+    range.sync = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    fences.push_back(range);
+}
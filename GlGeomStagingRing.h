@@ -0,0 +1,86 @@
+/*
+* GlGeomStagingRing.h - Version 0.9 - October 18, 2026
+*
+* A GlGeomStagingRing is a persistently mapped staging buffer, used as a
+*    ring buffer for uploading vertex and element data to VBO's and EBO's.
+*    The buffer is created with glBufferStorage and mapped once with
+*    GL_MAP_PERSISTENT_BIT and GL_MAP_COHERENT_BIT, so uploads never
+*    call glMapBuffer or reallocate buffer storage.
+*    Data is written into the ring, and copied on the GPU into the
+*    destination buffer with glCopyBufferSubData.  A fence is placed after
+*    the copies, and the ring only waits on a fence when it wraps around
+*    to a region that the GPU might still be reading.
+*
+* Requires OpenGL 4.4 or the ARB_buffer_storage extension.
+*    GlGeomStagingRing::Default() returns nullptr if these are not available,
+*    and GlGeomBase then falls back to mapping the VBO and EBO directly.
+*
+* An addition to the software accompanying POSSIBLE SECOND EDITION TO the book
+*		3D Computer Graphics: A Mathematical Introduction with OpenGL,
+*		by S. Buss, Cambridge University Press, 2003.
+*   Not part of the book's software, and not written by its author.
+*
+* Software is "as-is" and carries no warranty.  It may be used without
+*   restriction, but if you modify it, please change the filenames to
+*   prevent confusion between different versions.
+* Web page of the book's software: http://math.ucsd.edu/~sbuss/MathCG2
+*/
+
+#pragma once
+#ifndef GLGEOM_STAGING_RING_H
+#define GLGEOM_STAGING_RING_H
+
+#include <deque>
+
+class GlGeomStagingRing
+{
+public:
+    GlGeomStagingRing(long long sizeInBytes = 4 << 20);
+    ~GlGeomStagingRing();
+
+    GlGeomStagingRing(const GlGeomStagingRing&) = delete;
+    GlGeomStagingRing& operator=(const GlGeomStagingRing&) = delete;
+
+    // The ring used by GlGeomBase for uploads. Created on first use (needs
+    //    a current OpenGL context).  Returns nullptr if buffer storage is not
+    //    supported, or if disabled with SetEnabled(false).
+    static GlGeomStagingRing* Default();
+    static void SetEnabled(bool enabled);
+    static bool IsSupported();
+    static void DeleteDefault();        // Call before destroying the OpenGL context (optional)
+
+    // Reserve(): Get numBytes bytes of mapped memory to write into.
+    //    Returns nullptr if numBytes is larger than the ring.
+    //    *offset is set to the offset in the ring buffer, for CopyToBuffer() and Fence().
+    //    Waits only if the GPU may still be reading this part of the ring.
+    void* Reserve(long long numBytes, long long* offset);
+
+    // Copy from the ring to a buffer object, on the GPU.
+    //    Binds only GL_COPY_READ_BUFFER and GL_COPY_WRITE_BUFFER (nothing, with direct state access).
+    void CopyToBuffer(long long ringOffset, unsigned int dstBuffer, long long dstOffset, long long numBytes);
+
+    // Fence(): Call after the copies for a reserved range have been issued.
+    void Fence(long long offset, long long numBytes);
+
+    unsigned int GetBuffer() const { return ringBuffer; }
+    long long GetSize() const { return ringSize; }
+    long long GetNumWaits() const { return numWaits; }    // Number of times Reserve() had to wait
+
+private:
+    struct FencedRange {
+        long long start;
+        long long end;
+        void* sync;             // The GLsync
+    };
+
+    unsigned int ringBuffer = 0;
+    unsigned char* mappedPtr = nullptr;
+    long long ringSize;
+    long long head = 0;         // Next free byte
+    std::deque<FencedRange> fences;     // Oldest first
+    long long numWaits = 0;
+
+    void WaitForFront();
+};
+
+#endif  // GLGEOM_STAGING_RING_H
@@ -0,0 +1,242 @@
+/*
+* GlGeomStateCache.cpp - Version 0.9 - October 18, 2026
+*
+* Tracks OpenGL state, and drops calls that would not change it.
+*    See GlGeomStateCache.h for more information.
+*
+* An addition to the software accompanying POSSIBLE SECOND EDITION TO the book
+*		3D Computer Graphics: A Mathematical Introduction with OpenGL,
+*		by S. Buss, Cambridge University Press, 2003.
+*   Not part of the book's software, and not written by its author.
+*
+* Software is "as-is" and carries no warranty.  It may be used without
+*   restriction, but if you modify it, please change the filenames to
+*   prevent confusion between different versions.
+* Web page of the book's software: http://math.ucsd.edu/~sbuss/MathCG2
+*/
+
+// Use the static library (so glew32.dll is not needed):
+#define GLEW_STATIC
+#include <GL/glew.h>
+#include <GLFW/glfw3.h>
+
+#include "GlGeomStateCache.h"
+
+namespace {
+    const unsigned int MaxAttribs = 16;     // The minimum GL_MAX_VERTEX_ATTRIBS
+
+    bool CacheEnabled = true;
+
+    // The current state, and whether it is known.
+    unsigned int CurVao = 0;
+    bool VaoKnown = false;
+    unsigned int CurProgram = 0;
+    bool ProgramKnown = false;
+    float CurAttribs[MaxAttribs][4];
+    bool AttribKnown[MaxAttribs] = {};
+    bool CurDepthTest = false;
+    bool DepthTestKnown = false;
+    unsigned int CurDepthFunc = 0;
+    bool DepthFuncKnown = false;
+    bool CurCullFace = false;
+    bool CullFaceKnown = false;
+    unsigned int CurCullFaceMode = 0;
+    bool CullFaceModeKnown = false;
+    unsigned int CurPolygonMode = 0;
+    bool PolygonModeKnown = false;
+
+    long long NumCalls[(int)GlGeomStateKind::NumKinds] = {};
+    long long NumSkipped[(int)GlGeomStateKind::NumKinds] = {};
+
+    // Returns true if the call is needed, and counts it.
+    bool Changes(GlGeomStateKind kind, bool known, bool same)
+    {
+        if (CacheEnabled && known && same) {
+            NumSkipped[(int)kind]++;
+            return false;
+        }
+        NumCalls[(int)kind]++;
+        return true;
+    }
+}
+
+void GlGeomStateCache::SetEnabled(bool enabled)
+{
+    CacheEnabled = enabled;
+    Invalidate();
+}
+
+bool GlGeomStateCache::IsEnabled()
+{
+    return CacheEnabled;
+}
+
+void GlGeomStateCache::BindVertexArray(unsigned int vao)
+{
+    if (Changes(GlGeomStateKind::VertexArray, VaoKnown, CurVao == vao)) {
+        glBindVertexArray(vao);
+        CurVao = vao;
+        VaoKnown = true;
+    }
+}
+
+void GlGeomStateCache::UseProgram(unsigned int program)
+{
+    if (Changes(GlGeomStateKind::Program, ProgramKnown, CurProgram == program)) {
+        glUseProgram(program);
+        CurProgram = program;
+        ProgramKnown = true;
+    }
+}
+
+void GlGeomStateCache::VertexAttrib3f(unsigned int loc, float x, float y, float z)
+{
+    VertexAttrib4f(loc, x, y, z, 1.0f);     // The same as glVertexAttrib3f
+}
+
+void GlGeomStateCache::VertexAttrib4f(unsigned int loc, float x, float y, float z, float w)
+{
+    if (loc >= MaxAttribs) {
+        NumCalls[(int)GlGeomStateKind::Attrib]++;
+        glVertexAttrib4f(loc, x, y, z, w);
+        return;
+    }
+    float* cur = CurAttribs[loc];
+    bool same = (cur[0] == x && cur[1] == y && cur[2] == z && cur[3] == w);
+    if (Changes(GlGeomStateKind::Attrib, AttribKnown[loc], same)) {
+        glVertexAttrib4f(loc, x, y, z, w);
+        cur[0] = x;
+        cur[1] = y;
+        cur[2] = z;
+        cur[3] = w;
+        AttribKnown[loc] = true;
+    }
+}
+
+void GlGeomStateCache::SetDepthTest(bool enabled)
+{
+    if (Changes(GlGeomStateKind::DepthTest, DepthTestKnown, CurDepthTest == enabled)) {
+        if (enabled) {
+            glEnable(GL_DEPTH_TEST);
+        }
+        else {
+            glDisable(GL_DEPTH_TEST);
+        }
+        CurDepthTest = enabled;
+        DepthTestKnown = true;
+    }
+}
+
+void GlGeomStateCache::DepthFunc(unsigned int func)
+{
+    if (Changes(GlGeomStateKind::DepthFunc, DepthFuncKnown, CurDepthFunc == func)) {
+        glDepthFunc(func);
+        CurDepthFunc = func;
+        DepthFuncKnown = true;
+    }
+}
+
+void GlGeomStateCache::SetCullFace(bool enabled)
+{
+    if (Changes(GlGeomStateKind::CullFace, CullFaceKnown, CurCullFace == enabled)) {
+        if (enabled) {
+            glEnable(GL_CULL_FACE);
+        }
+        else {
+            glDisable(GL_CULL_FACE);
+        }
+        CurCullFace = enabled;
+        CullFaceKnown = true;
+    }
+}
+
+void GlGeomStateCache::CullFace(unsigned int mode)
+{
+    if (Changes(GlGeomStateKind::CullFaceMode, CullFaceModeKnown, CurCullFaceMode == mode)) {
+        glCullFace(mode);
+        CurCullFaceMode = mode;
+        CullFaceModeKnown = true;
+    }
+}
+
+void GlGeomStateCache::PolygonMode(unsigned int mode)
+{
+    if (Changes(GlGeomStateKind::PolygonMode, PolygonModeKnown, CurPolygonMode == mode)) {
+        glPolygonMode(GL_FRONT_AND_BACK, mode);
+        CurPolygonMode = mode;
+        PolygonModeKnown = true;
+    }
+}
+
+// Deleting the bound VAO or the current program makes 0 current.
+void GlGeomStateCache::DeleteVertexArray(unsigned int vao)
+{
+    glDeleteVertexArrays(1, &vao);
+    if (VaoKnown && CurVao == vao) {
+        CurVao = 0;
+    }
+}
+
+// A program in use is only deleted when it is no longer in use, so the current program is unchanged.
+void GlGeomStateCache::DeleteProgram(unsigned int program)
+{
+    glDeleteProgram(program);
+}
+
+void GlGeomStateCache::Invalidate()
+{
+    VaoKnown = false;
+    ProgramKnown = false;
+    for (unsigned int i = 0; i < MaxAttribs; i++) {
+        AttribKnown[i] = false;
+    }
+    DepthTestKnown = false;
+    DepthFuncKnown = false;
+    CullFaceKnown = false;
+    CullFaceModeKnown = false;
+    PolygonModeKnown = false;
+}
+
+void GlGeomStateCache::InvalidateAttrib(unsigned int loc)
+{
+    if (loc < MaxAttribs) {
+        AttribKnown[loc] = false;
+    }
+}
+
+unsigned int GlGeomStateCache::GetVertexArray()
+{
+    return CurVao;
+}
+
+unsigned int GlGeomStateCache::GetProgram()
+{
+    return CurProgram;
+}
+
+long long GlGeomStateCache::GetNumCalls(GlGeomStateKind kind)
+{
+    return NumCalls[(int)kind];
+}
+
+long long GlGeomStateCache::GetNumSkipped(GlGeomStateKind kind)
+{
+    return NumSkipped[(int)kind];
+}
+
+long long GlGeomStateCache::GetTotalSkipped()
+{
+    long long total = 0;
+    for (int i = 0; i < (int)GlGeomStateKind::NumKinds; i++) {
+        total += NumSkipped[i];
+    }
+    return total;
+}
+
+void GlGeomStateCache::ResetCounters()
+{
+    for (int i = 0; i < (int)GlGeomStateKind::NumKinds; i++) {
+        NumCalls[i] = 0;
+        NumSkipped[i] = 0;
+    }
+}
@@ -0,0 +1,88 @@
+/*
+* GlGeomStateCache.h - Version 0.9 - October 18, 2026
+*
+* GlGeomStateCache is a thin layer in front of the OpenGL calls that change
+*    the bound VAO, the shader program, constant vertex attributes (glVertexAttrib*),
+*    depth testing, back face culling and the polygon mode.  It remembers the current state,
+*    and drops calls which would not change it.  The calls made and the
+*    calls dropped are counted.
+*    With small meshes, most of the CPU time of a frame is spent in the driver,
+*    so fewer redundant calls means a faster frame.
+*
+* All changes of this state must go through GlGeomStateCache, or else Invalidate()
+*    must be called afterwards.  The state is that of the main OpenGL context.
+*    Deleting a bound VAO or program unbinds it: use DeleteVertexArray() and DeleteProgram().
+*    The constant value of an attribute is undefined after drawing with a vertex
+*    array enabled for the attribute: call InvalidateAttrib() in that case.
+*
+* With the cache enabled, GlGeomBase leaves the VAO bound after rendering, since
+*    every VAO bind goes through the cache and the next bind of the same VAO is free.
+*    So after rendering, the VAO of the last shape drawn is still bound. Code
+*    outside the GlGeom classes must not bind a GL_ELEMENT_ARRAY_BUFFER, or set
+*    vertex attribute pointers, without binding its own VAO (or VAO 0, through
+*    BindVertexArray()) first: that would silently change the shape's VAO.
+*    Use SetEnabled(false) if other code cannot do this: then every draw unbinds its VAO.
+*
+* An addition to the software accompanying POSSIBLE SECOND EDITION TO the book
+*		3D Computer Graphics: A Mathematical Introduction with OpenGL,
+*		by S. Buss, Cambridge University Press, 2003.
+*   Not part of the book's software, and not written by its author.
+*
+* Software is "as-is" and carries no warranty.  It may be used without
+*   restriction, but if you modify it, please change the filenames to
+*   prevent confusion between different versions.
+* Web page of the book's software: http://math.ucsd.edu/~sbuss/MathCG2
+*/
+
+#pragma once
+#ifndef GLGEOM_STATE_CACHE_H
+#define GLGEOM_STATE_CACHE_H
+
+// The kinds of state, for the counters.
+enum class GlGeomStateKind {
+    VertexArray,
+    Program,
+    Attrib,
+    DepthTest,
+    DepthFunc,
+    CullFace,
+    CullFaceMode,
+    PolygonMode,
+    NumKinds
+};
+
+class GlGeomStateCache
+{
+public:
+    // When disabled, every call is passed on to OpenGL (the counters still count).
+    static void SetEnabled(bool enabled);
+    static bool IsEnabled();
+
+    static void BindVertexArray(unsigned int vao);
+    static void UseProgram(unsigned int program);
+    static void VertexAttrib3f(unsigned int loc, float x, float y, float z);
+    static void VertexAttrib4f(unsigned int loc, float x, float y, float z, float w);
+    static void SetDepthTest(bool enabled);         // glEnable/glDisable(GL_DEPTH_TEST)
+    static void DepthFunc(unsigned int func);       // glDepthFunc(func)
+    static void SetCullFace(bool enabled);          // glEnable/glDisable(GL_CULL_FACE)
+    static void CullFace(unsigned int mode);        // glCullFace(mode)
+    static void PolygonMode(unsigned int mode);     // glPolygonMode(GL_FRONT_AND_BACK, mode)
+
+    static void DeleteVertexArray(unsigned int vao);
+    static void DeleteProgram(unsigned int program);
+
+    // Forget the current state (e.g., after other code has changed it directly).
+    static void Invalidate();
+    static void InvalidateAttrib(unsigned int loc);
+
+    static unsigned int GetVertexArray();       // The bound VAO, as far as the cache knows
+    static unsigned int GetProgram();
+
+    // Counters: the calls passed on to OpenGL, and the calls dropped.
+    static long long GetNumCalls(GlGeomStateKind kind);
+    static long long GetNumSkipped(GlGeomStateKind kind);
+    static long long GetTotalSkipped();
+    static void ResetCounters();
+};
+
+#endif  // GLGEOM_STATE_CACHE_H
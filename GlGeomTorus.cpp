@@ -25,88 +25,121 @@
 #include <GLFW/glfw3.h>
 
 #include "GlGeomTorus.h"
+#include "GlGeomParametric.h"
 #include "MathMisc.h"
 #include "assert.h"
+#include <stdio.h>
+
+const char* const GlGeomTorus::UniformName = "torusRadii";
+
+// The radii are (major, minor).  The positions in the VBO are on the circle of radius 1,
+//    and the normals point out from it, so neither is changed by the radii.
+static const char* TorusShaderRadiusSource =
+"uniform vec2 torusRadii;       // Set by GlGeomTorus::LoadRadiiUniform()\n"
+"vec3 TorusPosition(vec3 vertPos, vec3 vertNormal, vec2 radii)\n"
+"{\n"
+"   return radii.x * vertPos + radii.y * vertNormal;\n"
+"}\n"
+"vec3 TorusPosition(vec3 vertPos, vec3 vertNormal)\n"
+"{\n"
+"   return TorusPosition(vertPos, vertNormal, torusRadii);\n"
+"}\n"
+"vec3 TorusPositionInstanced(vec3 vertPos, vec3 vertNormal, float instScale)\n"
+"{\n"
+"   return TorusPosition(vertPos, vertNormal, vec2(1.0, instScale));\n"
+"}\n";
 
 
 void GlGeomTorus::Remesh(int sides, int rings, float minorRadius)
 {
+    sides = ClampRange(sides, 3, 255);
+    rings = ClampRange(rings, 3, 255);
     if (sides == numSides && rings == numRings && minorRadius == radius) {
         return;
     }
-    numSides = ClampRange(sides, 3, 255);
-    numRings = ClampRange(rings, 3, 255);
+    // If only the minor radius changes, only the vertex positions and normals are rewritten.
+    //    In shader radius mode, the mesh does not depend on the minor radius at all.
+    bool verticesOnly = (sides == numSides && rings == numRings);
+    if (verticesOnly && shaderRadius) {
+        radius = minorRadius;
+        return;
+    }
+    numSides = sides;
+    numRings = rings;
     radius = minorRadius;           // Should be between 0.0 and 1.0
 
-    VboEboLoaded = false;
+    SetMeshDirty(verticesOnly);
 }
 
+void GlGeomTorus::SetShaderRadius(bool inShader)
+{
+    if (inShader == shaderRadius) {
+        return;
+    }
+    shaderRadius = inShader;
+    SetMeshDirty();         // The shape key and FitsUnitCube() change too, not only the vertices
+}
 
-void GlGeomTorus::CalcVboAndEbo(float* VBOdataBuffer, unsigned int* EBOdataBuffer,
-    int vertPosOffset, int vertNormalOffset, int vertTexCoordsOffset, unsigned int stride)
+const char* GlGeomTorus::GetShaderSource()
 {
-    assert(vertPosOffset >= 0 && stride > 0);
-    bool calcNormals = (vertNormalOffset >= 0);       // Should normals be calculated?
-    bool calcTexCoords = (vertTexCoordsOffset >= 0);  // Should texture coordinates be calculated?
-
-    // VBO Data is laid out: Around each ring. Starting with ring at x==0 and z<0.
-    //          Each ring starts at the innermost seam of the torus (nearest to the y-axis).
-    float* toPtr = VBOdataBuffer;
-
-    // Outermost loop over the rings
-    int stopRings = calcTexCoords ? numRings : numRings-1;
-    for (int i = 0; i <= stopRings; i++) {
-        // Handle a ring of vertices.
-        // theta measures from the negative z-axis, counterclockwise viewed from above.
-        float sCoord = ((float)(i)) / (float)(numRings);
-        float theta = (float)PI2 * ((float)(i%numRings)) / (float)(numRings);
-        float c = -cosf(theta);      // Negated values (start at negative z-axis)
-        float s = -sinf(theta);
-        int stopSides = calcTexCoords ? numSides : numSides - 1;
-        for (int j = 0; j <= stopSides; j++, toPtr += stride) {
-            // phi measures from the inner seam, going under, around and over, back to the inner seam.
-            float tCoord = ((float)(j)) / (float)(numSides);
-            float phi = (float)PI2 * ((float)(j%numSides)) / (float)(numSides);
-            float cphi = -cosf(phi);      // Negated value (start at inner seam)
-            float sphi = -sinf(phi);       // Negated, start downward (-y)
-            float* posPtr = toPtr;
-            *(posPtr++) = s * (1.0f + radius * cphi);    // x coordinate
-            *(posPtr++) = radius*sphi;                  // y coordinate
-            *posPtr = c * (1.0f + radius * cphi);        // z coordinate
-            if (calcNormals) {
-                float* nPtr = toPtr + vertNormalOffset;
-                *(nPtr++) = s * cphi;           // Normal in x direction
-                *(nPtr++) = sphi;                  // Normal in y direction
-                *nPtr = c * cphi;               // Normal in z direction
-            }
-            if (calcTexCoords) {
-                float* tcPtr = toPtr + vertTexCoordsOffset;
-                *(tcPtr++) = sCoord;
-                *tcPtr = tCoord;
-            }
-        }
+    return TorusShaderRadiusSource;
+}
 
-        // EBO data is also laid out in the same order, for GL_TRIANGLES
-        unsigned int* eboPtr = EBOdataBuffer;
-        int ringDelta = calcTexCoords ? numSides + 1 : numSides;
-        for (int ii = 0; ii < numRings; ii++) {
-            int iii = calcTexCoords ? (ii + 1) : ((ii + 1) % numRings);
-            int leftR = ii * ringDelta;
-            int rightR = iii *ringDelta;
-            for (int j = 0; j < numSides; j++) {
-                int jj = calcTexCoords ? (j + 1) : ((j + 1) % numSides);
-                *(eboPtr++) = rightR + j;
-                *(eboPtr++) = leftR + jj;
-                *(eboPtr++) = leftR+j;
-
-                *(eboPtr++) = rightR + j;
-                *(eboPtr++) = rightR + jj;
-                *(eboPtr++) = leftR + jj;
-            }
-        }
+void GlGeomTorus::LoadRadiiUniform(int radii_loc) const
+{
+    glUniform2f(radii_loc, GetMajorRadius(), radius);
+}
+
+std::string GlGeomTorus::GetShapeKey() const
+{
+    char key[64];
+    if (shaderRadius) {
+        snprintf(key, sizeof(key), "GlGeomTorus %d %d shader", numSides, numRings);
+    }
+    else {
+        snprintf(key, sizeof(key), "GlGeomTorus %d %d %.9g", numSides, numRings, radius);
     }
+    return std::string(key);
 }
 
+// The torus, as a parametric surface (see GlGeomParametric.h).
+//    theta (u) measures from the negative z-axis, counterclockwise viewed from above.
+//    phi (v) measures from the inner seam, going under, around and over, back to the inner seam.
+struct GlGeomTorusSurface {
+    static const bool Poles = false;
+    float radius;           // Minor radius
+    void EvalRow(float costheta, float sintheta, int n, const float* cosphi, const float* sinphi,
+        GlGeomParametricRow row) const
+    {
+        float c = -costheta;        // Negated values (start at negative z-axis)
+        float s = -sintheta;
+        float r = radius;
+        for (int j = 0; j < n; j++) {
+            float cphi = -cosphi[j];        // Negated value (start at inner seam)
+            float sphi = -sinphi[j];        // Negated, start downward (-y)
+            row.x[j] = s * (1.0f + r * cphi);
+            row.y[j] = r * sphi;
+            row.z[j] = c * (1.0f + r * cphi);
+            row.nx[j] = s * cphi;
+            row.ny[j] = sphi;
+            row.nz[j] = c * cphi;
+        }
+    }
+};
+
+// VBO Data is laid out: Around each ring. Starting with ring at x==0 and z<0.
+//          Each ring starts at the innermost seam of the torus (nearest to the y-axis).
+// EBO data is also laid out in the same order, for GL_TRIANGLES
+void GlGeomTorus::CalcVboAndEbo(float* VBOdataBuffer, unsigned int* EBOdataBuffer,
+    int vertPosOffset, int vertNormalOffset, int vertTexCoordsOffset, unsigned int stride)
+{
+    assert(vertPosOffset >= 0 && stride > 0);
+    assert(!shaderRadius || vertNormalOffset >= 0);     // The shader needs the normals
+    GlGeomTorusSurface surface;
+    surface.radius = shaderRadius ? 0.0f : radius;      // Radius 0 gives the center circle
+    GlGeomParametricCalc(surface, numRings, numSides, VBOdataBuffer, EBOdataBuffer,
+        vertPosOffset, vertNormalOffset, vertTexCoordsOffset, stride);
+}
 
 void GlGeomTorus::InitializeAttribLocations(
     unsigned int pos_loc, unsigned int normal_loc, unsigned int texcoords_loc)
@@ -114,25 +147,16 @@ void GlGeomTorus::InitializeAttribLocations(
     // The call to GlGeomBase::InitializeAttribLocations will further call
     //   GlGeomSphere::CalcVboAndEbo()
 
+    assert((!shaderRadius || normal_loc != UINT_MAX) && "Shader radius mode needs the normal attribute!");
     GlGeomBase::InitializeAttribLocations(pos_loc, normal_loc, texcoords_loc);
-    VboEboLoaded = true;
 }
 
 
 // **********************************************
 // These routines do the rendering.
-// If the torus's VAO, VBO, EBO need to be loaded, it does this first.
+// If the torus's VBO and EBO need to be updated, PreRender() does this first.
 // **********************************************
 
-void GlGeomTorus::PreRender()
-{
-    GlGeomBase::PreRender();
-
-    if (!VboEboLoaded) {
-        ReInitializeAttribLocations();
-    }
-}
-
 // Render entire torus as triangles
 void GlGeomTorus::Render()
 {
@@ -151,27 +175,28 @@ void GlGeomTorus::RenderRing(int i)
 }
 
 // Render one strip of sides as a triangle strip
-//   Rebuilds the EBO every time it is called.
 void GlGeomTorus::RenderSideStrip(int j)
 {
     assert(j >= 0 && j < numSides);
     PreRender();
 
-    // Create the EBO (element buffer data) for the i-th side (wedge) as a triangle strip.
-    int numElts = 2 * (numRings + 1);
-    unsigned int* sideElts = new unsigned int[numElts];
-    int numEltsPerRing = UseTexCoords() ? numSides + 1 : numSides;
-    int delta = UseTexCoords() ? 1 : (((j+1)%numRings) - j);
-    unsigned int* toElt = sideElts;
-    for (int i = 0; i <= numRings; i++) {
-        int ii = UseTexCoords() ? i : (i%numRings);
-        int eltA = ii * numEltsPerRing + j;
-        *(toElt++) = eltA+delta;
-        *(toElt++) = eltA;
-    }
-
-    // Render the triangle strip
-    GlGeomBase::RenderElements(GL_TRIANGLE_STRIP, numElts, sideElts);
+    int stripLen = GetNumElementsPerSideStrip();
+    GlGeomBase::RenderEBO(GL_TRIANGLE_STRIP, stripLen, GetNumElements() + j*stripLen);
 }
 
-
+// Calculate the elements for the side strips, placed in the EBO after the GL_TRIANGLES elements.
+void GlGeomTorus::CalcSubRangeElements(unsigned int* EBOdataBuffer, bool calcTexCoords)
+{
+    int numEltsPerRing = calcTexCoords ? numSides + 1 : numSides;
+    unsigned int* toElt = EBOdataBuffer;
+    for (int j = 0; j < numSides; j++) {
+        int delta = calcTexCoords ? 1 : (((j + 1) % numSides) - j);
+        for (int i = 0; i <= numRings; i++) {
+            int ii = calcTexCoords ? i : (i%numRings);
+            int eltA = ii * numEltsPerRing + j;
+            *(toElt++) = eltA + delta;
+            *(toElt++) = eltA;
+        }
+    }
+    assert(toElt - EBOdataBuffer == GetNumSubRangeElements());
+}
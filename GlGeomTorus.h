@@ -24,6 +24,7 @@
 
 #include "GlGeomBase.h"
 #include <limits.h>
+#include <assert.h>
 
 // GlGeomTorus
 //     Generates vertices, normals, and texture coodinates for a torus.
@@ -49,6 +50,26 @@
 // The number of rings = number of cuts at right angles to the inner circular path.
 //         E.g. To share a doughtnut four ways, you would want to cut four rings.
 // The number of sides = number of wedges around the inner circular path.
+//
+// Shader radius mode (SetShaderRadius(true)): The minor radius is applied in the
+//     vertex shader instead of in the VBO, so the thickness can be animated, or
+//     set per instance, with no re-meshing and no re-upload.
+//     The positions in the VBO are the points on the center circle of the tube
+//     (major radius 1), and the normals are the unit directions out from the
+//     center circle. So the normal attribute must be used. The shader calculates:
+//         vec3 pos = majorRadius*vertPos + minorRadius*vertNormal;
+//     with the radii in uniforms, or in per-instance or per-draw data.
+//     The normal is unchanged.  Tori with the same numbers of sides and rings share
+//     their mesh in this mode, whatever their minor radii.
+//     Meshlet culling is not done in this mode (see GlGeomBase::CanCullMeshlets()).
+//     GetShaderSource() has the GLSL for this.  The vertex shader includes it after
+//     its #version line, and calls one of:
+//         TorusPosition(vertPos, vertNormal)           // Radii in the uniform UniformName
+//         TorusPosition(vertPos, vertNormal, radii)    // Radii from elsewhere, e.g. per-draw data
+//         TorusPositionInstanced(vertPos, vertNormal, instScale)
+//     The instanced version is for RenderInstanced() (see GlGeomInstances.h): the
+//     instance's scale is its minor radius, and its matrix scales the major radius.
+//     For the uniform, call LoadRadiiUniform() with the program in use.
 
 
 class GlGeomTorus : public GlGeomBase
@@ -79,9 +100,36 @@ public:
     // Selectively render a ring or a strip of sides
     // Ring numbers i rangle from 0 to numRings-1.
     // Stack numbers j are allowed to range from 1 to numStacks-2.
+    // The side strips are stored in the EBO after the triangles,
+    //    so these are both single draw calls from the EBO.
     void RenderRing(int i);         // Renders the i-th ring as triangles
     void RenderSideStrip(int j);    // Renders the j-th side-strip as a triangle strip
 
+    // SetConstMesh(): Use the mesh generated at compile time, instead of calculating it.
+    //    Its sides, rings and minor radius must be the same as the torus's. See GlGeomConstMesh.h.
+    template<int Sides, int Rings, GlGeomConstLayout Layout>
+    void SetConstMesh(const ConstTorusMesh<Sides, Rings, Layout>& mesh) {
+        assert(Sides == numSides && Rings == numRings && mesh.minorRadius == radius && !shaderRadius);
+        SetConstMeshData(mesh.GetData());
+    }
+
+    // SetShaderRadius(): Apply the minor radius in the vertex shader (see above).
+    //    Best called before InitializeAttribLocations(). If called afterwards,
+    //    the mesh is rebuilt (with a new vertex layout and mesh key). In this mode, Remesh() with only a new minor radius
+    //    does not change the mesh: load GetMinorRadius() into the shader instead.
+    void SetShaderRadius(bool inShader);
+    bool UsesShaderRadius() const { return shaderRadius; }
+
+    // The GLSL (version 330) for shader radius mode, and its uniform (see above).
+    static const char* const UniformName;       // "torusRadii", a vec2: (major radius, minor radius)
+    static const char* GetShaderSource();
+    // LoadRadiiUniform(): Load the major and minor radii into the uniform at radii_loc.
+    void LoadRadiiUniform(int radii_loc) const;
+
+    // In shader radius mode the positions are on the unit circle.
+    bool FitsUnitCube() const { return shaderRadius; }
+    bool CanCullMeshlets() const { return !shaderRadius; }
+
     int GetNumSides() const { return numSides; }
     int GetNumRings() const { return numRings; }
     float GetMinorRadius() const { return radius; }
@@ -97,32 +145,41 @@ public:
 
     int GetNumElementsPerRing() const { return numSides * 6; }
 
+    // Extra elements in the EBO: a triangle strip for each side.
+    int GetNumElementsPerSideStrip() const { return 2 * (numRings + 1); }
+    int GetNumSubRangeElements() const { return numSides * GetNumElementsPerSideStrip(); }
+
+    // Tori with the same numbers of sides and rings and the same minor radius
+    //    share their VAO, VBO and EBO.  (In shader radius mode, the minor radius can differ.)
+    std::string GetShapeKey() const;
+
+    // Can be moved (e.g., kept in a std::vector), but not copied.
+    GlGeomTorus(GlGeomTorus&&) = default;
+    GlGeomTorus& operator=(GlGeomTorus&&) = default;
+
 private:
+    friend class GlGeomTorusLOD;        // Calculates its levels with CalcVboAndEbo()
 
     // CalcVboAndEbo- return all VBO vertex information, and EBO elements for GL_TRIANGLES drawing.
     // See GlGeomBase.h for additional information
     void CalcVboAndEbo(float* VBOdataBuffer, unsigned int* EBOdataBuffer,
         int vertPosOffset, int vertNormalOffset, int vertTexCoordsOffset,
         unsigned int stride);
+    void CalcSubRangeElements(unsigned int* EBOdataBuffer, bool calcTexCoords);
  
-    // Disable all copy and assignment operators.
-	// A GlGeomTorus can be allocated as a global or static variable, or with new.
+    // Disable the copy constructor and copy assignment (moving is allowed, see above).
+	// A GlGeomTorus can be allocated as a global or static variable, with new, or in a std::vector.
 	//     If you need to pass it to/from a function, use references or pointers
     //     and be sure that there are no implicit copy or assignment operations!
     GlGeomTorus(const GlGeomTorus&) = delete;
     GlGeomTorus& operator=(const GlGeomTorus&) = delete;
-    GlGeomTorus(GlGeomTorus&&) = delete;
-    GlGeomTorus& operator=(GlGeomTorus&&) = delete;
 
 private:
     int numSides;           // Number sides going around the inner circular path
     int numRings;           // Number of ring-like pieces (perpindicular to the inner path)
     float radius;           // Minor radius (major radius is fixed equal to 1.0).
+    bool shaderRadius = false;  // True if the minor radius is applied in the vertex shader
 
-private: 
-    bool VboEboLoaded = false;
-
-    void PreRender();
 };
 
 inline GlGeomTorus::GlGeomTorus(int sides, int rings, float minorRadius)
@@ -0,0 +1,287 @@
+/*
+* GlGeomTorusLOD.cpp - Version 0.9 - October 18, 2026
+*
+* C++ class for rendering tori at several levels of detail in Modern OpenGL.
+*    See GlGeomTorusLOD.h for more information.
+*
+* An addition to the software accompanying POSSIBLE SECOND EDITION TO the book
+*		3D Computer Graphics: A Mathematical Introduction with OpenGL,
+*		by S. Buss, Cambridge University Press, 2003.
+*   Not part of the book's software, and not written by its author.
+*
+* Software is "as-is" and carries no warranty.  It may be used without
+*   restriction, but if you modify it, please change the filenames to
+*   prevent confusion between different versions.
+* Web page of the book's software: http://math.ucsd.edu/~sbuss/MathCG2
+*/
+
+// Use the static library (so glew32.dll is not needed):
+#define GLEW_STATIC
+#include <GL/glew.h>
+#include <GLFW/glfw3.h>
+
+#include "LinearR4.h"
+#include "MathMisc.h"
+#include "assert.h"
+#include <stdio.h>
+
+#include "GlGeomTorusLOD.h"
+#include "GlGeomTorus.h"
+
+// Needed since MaxLevels is passed by reference (to ClampRange).
+const int GlGeomTorusLOD::MaxLevels;
+
+GlGeomTorusLOD::GlGeomTorusLOD(int levels, int baseSides, int baseRings, float minorRadius)
+{
+    numLevels = 0;
+    radius = minorRadius;
+    Remesh(levels, baseSides, baseRings, minorRadius);
+}
+
+void GlGeomTorusLOD::Remesh(int levels, int baseSides, int baseRings, float minorRadius)
+{
+    levels = ClampRange(levels, 1, MaxLevels);
+    int sides = ClampRange(baseSides, 3, 255);
+    int rings = ClampRange(baseRings, 3, 255);
+    if (levels == numLevels && sides == levelSides[0] && rings == levelRings[0] && minorRadius == radius) {
+        return;
+    }
+    // If only the minor radius changes, only the vertex positions and normals are rewritten.
+    bool verticesOnly = (levels == numLevels && sides == levelSides[0] && rings == levelRings[0]);
+    numLevels = levels;
+    for (int i = 0; i < numLevels; i++) {
+        levelSides[i] = sides;
+        levelRings[i] = rings;
+        sides = Min(2 * sides, 255);
+        rings = Min(2 * rings, 255);
+    }
+    radius = minorRadius;           // Should be between 0.0 and 1.0
+    SetMeshDirty(verticesOnly);
+}
+
+std::string GlGeomTorusLOD::GetShapeKey() const
+{
+    char key[64];
+    snprintf(key, sizeof(key), "GlGeomTorusLOD %d %d %d %.9g", numLevels, levelSides[0], levelRings[0], radius);
+    return std::string(key);
+}
+
+// The meshes are in the order of their mesh numbers.
+int GlGeomTorusLOD::GetLevelFirstElement(int sideLevel, int ringLevel) const
+{
+    int first = 0;
+    int mesh = GetMeshNumber(sideLevel, ringLevel);
+    for (int m = 0; m < mesh; m++) {
+        first += GetLevelNumElements(m / numLevels, m % numLevels);
+    }
+    return first;
+}
+
+int GlGeomTorusLOD::GetLevelFirstVertex(int sideLevel, int ringLevel, bool calcTexCoords) const
+{
+    int first = 0;
+    int mesh = GetMeshNumber(sideLevel, ringLevel);
+    for (int m = 0; m < mesh; m++) {
+        int sides = levelSides[m / numLevels];
+        int rings = levelRings[m % numLevels];
+        first += calcTexCoords ? (sides + 1)*(rings + 1) : sides * rings;
+    }
+    return first;
+}
+
+// The side strips of the meshes come after the GL_TRIANGLES elements of all the meshes.
+int GlGeomTorusLOD::GetLevelFirstSideStrip(int sideLevel, int ringLevel) const
+{
+    int first = GetNumElements();
+    int mesh = GetMeshNumber(sideLevel, ringLevel);
+    for (int m = 0; m < mesh; m++) {
+        first += levelSides[m / numLevels] * 2 * (levelRings[m % numLevels] + 1);
+    }
+    return first;
+}
+
+int GlGeomTorusLOD::GetNumElements() const
+{
+    return GetLevelFirstElement(numLevels, 0);
+}
+
+int GlGeomTorusLOD::GetNumVerticesTexCoords() const
+{
+    return GetLevelFirstVertex(numLevels, 0, true);
+}
+
+int GlGeomTorusLOD::GetNumVerticesNoTexCoords() const
+{
+    return GetLevelFirstVertex(numLevels, 0, false);
+}
+
+int GlGeomTorusLOD::GetNumSubRangeElements() const
+{
+    return GetLevelFirstSideStrip(numLevels, 0) - GetNumElements();
+}
+
+// Create the VBO and EBO data for all the meshes.
+//    Each mesh is calculated by a GlGeomTorus, then its elements are offset
+//    to the mesh's first vertex.
+void GlGeomTorusLOD::CalcVboAndEbo(float* VBOdataBuffer, unsigned int* EBOdataBuffer,
+    int vertPosOffset, int vertNormalOffset, int vertTexCoordsOffset, unsigned int stride)
+{
+    bool calcTexCoords = (vertTexCoordsOffset >= 0);
+    unsigned int firstVertex = 0;
+    unsigned int* toEbo = EBOdataBuffer;
+    for (int s = 0; s < numLevels; s++) {
+        for (int r = 0; r < numLevels; r++) {
+            GlGeomTorus level(levelSides[s], levelRings[r], radius);
+            level.CalcVboAndEbo(VBOdataBuffer + stride*firstVertex, toEbo,
+                vertPosOffset, vertNormalOffset, vertTexCoordsOffset, stride);
+            if (toEbo != nullptr) {
+                int numElts = level.GetNumElements();
+                for (int k = 0; k < numElts; k++) {
+                    toEbo[k] += firstVertex;
+                }
+                toEbo += numElts;
+            }
+            firstVertex += calcTexCoords ? level.GetNumVerticesTexCoords() : level.GetNumVerticesNoTexCoords();
+        }
+    }
+    assert(toEbo == nullptr || toEbo - EBOdataBuffer == GetNumElements());
+}
+
+// EBOdataBuffer points just after the GL_TRIANGLES elements.
+void GlGeomTorusLOD::CalcSubRangeElements(unsigned int* EBOdataBuffer, bool calcTexCoords)
+{
+    unsigned int* toEbo = EBOdataBuffer;
+    for (int s = 0; s < numLevels; s++) {
+        for (int r = 0; r < numLevels; r++) {
+            GlGeomTorus level(levelSides[s], levelRings[r], radius);
+            level.CalcSubRangeElements(toEbo, calcTexCoords);
+            unsigned int firstVertex = GetLevelFirstVertex(s, r, calcTexCoords);
+            int numElts = level.GetNumSubRangeElements();
+            for (int k = 0; k < numElts; k++) {
+                toEbo[k] += firstVertex;
+            }
+            toEbo += numElts;
+        }
+    }
+    assert(toEbo - EBOdataBuffer == GetNumSubRangeElements());
+}
+
+void GlGeomTorusLOD::InitializeAttribLocations(
+    unsigned int pos_loc, unsigned int normal_loc, unsigned int texcoords_loc)
+{
+    GlGeomBase::InitializeAttribLocations(pos_loc, normal_loc, texcoords_loc);
+}
+
+// The rings follow the major circle, whose outer edge has radius 1+minorRadius.
+//    The sides follow the tube, with radius minorRadius.
+void GlGeomTorusLOD::SelectLevels(double majorPixelRadius, int* sideLevel, int* ringLevel,
+    GlGeomTorusLodState* state) const
+{
+    double neededSides = GlGeomChordSegments(radius * majorPixelRadius, maxPixelError);
+    double neededRings = GlGeomChordSegments((1.0 + radius) * majorPixelRadius, maxPixelError);
+    *sideLevel = GlGeomSelectLevel(levelSides, numLevels, neededSides, state ? &state->sides : nullptr);
+    *ringLevel = GlGeomSelectLevel(levelRings, numLevels, neededRings, state ? &state->rings : nullptr);
+}
+
+void GlGeomTorusLOD::RenderLevel(int sideLevel, int ringLevel)
+{
+    assert(sideLevel >= 0 && sideLevel < numLevels && ringLevel >= 0 && ringLevel < numLevels);
+    PreRender();
+    GlGeomBase::RenderEBO(GL_TRIANGLES, GetLevelNumElements(sideLevel, ringLevel),
+        GetLevelFirstElement(sideLevel, ringLevel));
+}
+
+// The rings of a mesh are consecutive in the EBO.
+void GlGeomTorusLOD::RenderRings(int sideLevel, int ringLevel, int i, int count)
+{
+    assert(sideLevel >= 0 && sideLevel < numLevels && ringLevel >= 0 && ringLevel < numLevels);
+    assert(i >= 0 && count >= 0 && i + count <= levelRings[ringLevel]);
+    PreRender();
+    int numElementsPerRing = 6 * levelSides[sideLevel];
+    GlGeomBase::RenderEBO(GL_TRIANGLES, count*numElementsPerRing,
+        GetLevelFirstElement(sideLevel, ringLevel) + i*numElementsPerRing);
+}
+
+void GlGeomTorusLOD::RenderSideStrip(int sideLevel, int ringLevel, int j)
+{
+    assert(sideLevel >= 0 && sideLevel < numLevels && ringLevel >= 0 && ringLevel < numLevels);
+    assert(j >= 0 && j < levelSides[sideLevel]);
+    PreRender();
+    int stripLen = 2 * (levelRings[ringLevel] + 1);
+    GlGeomBase::RenderEBO(GL_TRIANGLE_STRIP, stripLen, GetLevelFirstSideStrip(sideLevel, ringLevel) + j*stripLen);
+}
+
+int GlGeomTorusLOD::Render(const LinearMapR4& modelview, const LinearMapR4& projection,
+    int viewportHeight, GlGeomTorusLodState* state)
+{
+    double outerPixelRadius = GlGeomProjectedRadius(modelview, projection, viewportHeight, 1.0 + radius);
+    int sideLevel, ringLevel;
+    SelectLevels(outerPixelRadius / (1.0 + radius), &sideLevel, &ringLevel, state);
+    if (UsesMeshlets()) {
+        return RenderCulled(modelview, projection, GetMeshNumber(sideLevel, ringLevel));
+    }
+    PreRender();
+    CalcVisibleRings(sideLevel, ringLevel, modelview, projection);
+    RenderEBORanges(GL_TRIANGLES, (int)visibleCounts.size(), visibleCounts.data(), visibleStarts.data());
+    int numElts = 0;
+    for (int count : visibleCounts) {
+        numElts += count;
+    }
+    return numElts / 3;
+}
+
+// Find the ranges of elements for the rings inside the view frustum.
+//    Ring i covers the angles theta from i to i+1 times 2*pi/numRings around the y-axis.
+//    It lies in a sphere centered on the major circle at the middle angle, with radius
+//    the minor radius plus the chord from the middle to the end of the ring's arc.
+//    The frustum planes are the rows of projection*modelview, as in GlGeomMeshlets::Cull().
+//    Consecutive visible rings are merged into one range.
+void GlGeomTorusLOD::CalcVisibleRings(int sideLevel, int ringLevel,
+    const LinearMapR4& modelview, const LinearMapR4& projection)
+{
+    visibleCounts.clear();
+    visibleStarts.clear();
+    LinearMapR4 mvp = projection * modelview;
+    double planes[6][4];
+    const double rows[4][4] = {
+        { mvp.m11, mvp.m12, mvp.m13, mvp.m14 }, { mvp.m21, mvp.m22, mvp.m23, mvp.m24 },
+        { mvp.m31, mvp.m32, mvp.m33, mvp.m34 }, { mvp.m41, mvp.m42, mvp.m43, mvp.m44 } };
+    for (int i = 0; i < 3; i++) {
+        for (int k = 0; k < 4; k++) {
+            planes[2 * i][k] = rows[3][k] + rows[i][k];
+            planes[2 * i + 1][k] = rows[3][k] - rows[i][k];
+        }
+    }
+    double planeNorms[6];
+    for (int i = 0; i < 6; i++) {
+        planeNorms[i] = sqrt(planes[i][0] * planes[i][0] + planes[i][1] * planes[i][1] + planes[i][2] * planes[i][2]);
+    }
+
+    int rings = levelRings[ringLevel];
+    int numElementsPerRing = 6 * levelSides[sideLevel];
+    int firstElement = GetLevelFirstElement(sideLevel, ringLevel);
+    double ringRadius = radius + 2.0*sin(0.5*PI / (double)rings);
+    int runEnd = -1;            // Element just after the last range
+    for (int i = 0; i < rings; i++) {
+        double theta = ((double)i + 0.5)*PI2 / (double)rings;
+        double cx = -sin(theta);        // As in GlGeomTorusSurface, theta starts at the negative z-axis
+        double cz = -cos(theta);
+        bool culled = false;
+        for (int p = 0; p < 6 && !culled; p++) {
+            double dist = planes[p][0] * cx + planes[p][2] * cz + planes[p][3];
+            culled = (dist < -ringRadius * planeNorms[p]);
+        }
+        if (culled) {
+            continue;
+        }
+        int start = firstElement + i*numElementsPerRing;
+        if (start == runEnd) {
+            visibleCounts.back() += numElementsPerRing;
+        }
+        else {
+            visibleCounts.push_back(numElementsPerRing);
+            visibleStarts.push_back(start);
+        }
+        runEnd = start + numElementsPerRing;
+    }
+}
@@ -0,0 +1,157 @@
+/*
+* GlGeomTorusLOD.h - Version 0.9 - October 18, 2026
+*
+* C++ class for rendering tori at several levels of detail in Modern OpenGL.
+*   A GlGeomTorusLOD holds torus meshes for several numbers of sides and of rings,
+*   in a single VAO, VBO and EBO. Each draw renders one of the meshes.
+*   The numbers of sides and rings are chosen separately, from the sizes of the
+*   major and minor radii on the screen, so that every edge is within a
+*   given error in pixels of the true torus.  A thin ring far away is drawn
+*   with 3 sides and a few rings, and with many rings only when near.
+*   Only the rings inside the view frustum are rendered.
+*
+* How to use:
+*     GlGeomTorusLOD Ring(4, 3, 8, 0.02f); // Sides 3,6,12,24 and rings 8,16,32,64
+*     GlGeomTorusLodState RingLod;         // One for each object rendered
+*     ...
+*     Ring.InitializeAttribLocations(pos_loc);
+*     ...
+*     Ring.Render(ringModelview, projection, viewportHeight, &RingLod);
+*
+* An addition to the software accompanying POSSIBLE SECOND EDITION TO the book
+*		3D Computer Graphics: A Mathematical Introduction with OpenGL,
+*		by S. Buss, Cambridge University Press, 2003.
+*   Not part of the book's software, and not written by its author.
+*
+* Software is "as-is" and carries no warranty.  It may be used without
+*   restriction, but if you modify it, please change the filenames to
+*   prevent confusion between different versions.
+* Web page of the book's software: http://math.ucsd.edu/~sbuss/MathCG2
+*/
+
+#pragma once
+#ifndef GLGEOM_TORUS_LOD_H
+#define GLGEOM_TORUS_LOD_H
+
+#include "GlGeomBase.h"
+#include "GlGeomLOD.h"
+
+class LinearMapR4;
+
+// The levels last chosen for one rendered torus (see GlGeomLodState).
+struct GlGeomTorusLodState {
+    GlGeomLodState sides;
+    GlGeomLodState rings;
+};
+
+// GlGeomTorusLOD
+//     The meshes are tori the same as GlGeomTorus's, with major radius 1.
+//     Side level 0 and ring level 0 are the coarsest. Each level has twice the
+//        sides (or rings) of the one before.  There is a mesh for every pair
+//        of a side level and a ring level: mesh number sideLevel*numLevels + ringLevel.
+//     The vertices of all meshes are in the VBO.  The EBO holds the GL_TRIANGLES
+//        elements of all the meshes, one mesh after another, then the side strips
+//        (see GlGeomTorus::RenderSideStrip()) of all the meshes.
+
+class GlGeomTorusLOD : public GlGeomBase
+{
+public:
+    static const int MaxLevels = 6;
+
+    GlGeomTorusLOD() : GlGeomTorusLOD(4, 3, 8, 0.5f) {}
+    GlGeomTorusLOD(int numLevels, int baseSides, int baseRings, float minorRadius = 0.5f);
+
+    // Remesh: change the levels or the minor radius. Sides and rings are clamped to at most 255.
+    void Remesh(int numLevels, int baseSides, int baseRings) { Remesh(numLevels, baseSides, baseRings, radius); }
+    void Remesh(int numLevels, int baseSides, int baseRings, float minorRadius);
+
+    void InitializeAttribLocations(
+        unsigned int pos_loc, unsigned int normal_loc = UINT_MAX, unsigned int texcoords_loc = UINT_MAX);
+
+    // Render(): Render the finest mesh.
+    // RenderLevel(): Render the mesh for a side level and a ring level.
+    // Render(modelview, ...): Select the levels from the projected size, and render
+    //    the rings of that mesh which are inside the view frustum.
+    //    modelview - the modelview matrix loaded into the shader for this torus
+    //    projection - the projection matrix (from Set_glFrustum)
+    //    viewportHeight - in pixels
+    //    state - remembers the levels for this object (may be null, for no hysteresis)
+    //    Returns the number of triangles rendered.
+    //    If meshlets are used (SetUseMeshlets), the culled meshlets of the mesh are skipped instead.
+    void Render() { RenderLevel(numLevels - 1, numLevels - 1); }
+    void RenderLevel(int sideLevel, int ringLevel);
+    int Render(const LinearMapR4& modelview, const LinearMapR4& projection,
+        int viewportHeight, GlGeomTorusLodState* state = nullptr);
+
+    // Render parts of a mesh, as for GlGeomTorus.
+    //    RenderRings() renders count consecutive rings, starting at ring i, with one draw.
+    void RenderRing(int sideLevel, int ringLevel, int i) { RenderRings(sideLevel, ringLevel, i, 1); }
+    void RenderRings(int sideLevel, int ringLevel, int i, int count);
+    void RenderSideStrip(int sideLevel, int ringLevel, int j);
+
+    // SelectLevels(): The levels to use for a torus whose major radius is
+    //    majorPixelRadius pixels on the screen.
+    void SelectLevels(double majorPixelRadius, int* sideLevel, int* ringLevel,
+        GlGeomTorusLodState* state = nullptr) const;
+
+    // The largest distance on the screen, in pixels, from an edge to the true torus (default 0.5).
+    void SetMaxPixelError(double pixels) { maxPixelError = pixels; }
+    double GetMaxPixelError() const { return maxPixelError; }
+
+    int GetNumLevels() const { return numLevels; }
+    int GetNumSides(int sideLevel) const { return levelSides[sideLevel]; }
+    int GetNumRings(int ringLevel) const { return levelRings[ringLevel]; }
+    float GetMinorRadius() const { return radius; }
+    float GetMajorRadius() const { return 1.0; }
+
+    int GetMeshNumber(int sideLevel, int ringLevel) const { return sideLevel * numLevels + ringLevel; }
+    int GetLevelNumElements(int sideLevel, int ringLevel) const { return 6 * levelSides[sideLevel] * levelRings[ringLevel]; }
+    int GetLevelFirstElement(int sideLevel, int ringLevel) const;
+
+    // The meshes are the element groups (for meshlets, see GlGeomBase.h).
+    int GetNumElementGroups() const { return numLevels * numLevels; }
+    void GetElementGroup(int group, int* firstElement, int* numElements) const {
+        *firstElement = GetLevelFirstElement(group / numLevels, group % numLevels);
+        *numElements = GetLevelNumElements(group / numLevels, group % numLevels);
+    }
+
+    // Totals over all the meshes.
+    int GetNumElements() const;
+    int GetNumVerticesTexCoords() const;
+    int GetNumVerticesNoTexCoords() const;
+    int GetNumSubRangeElements() const;
+
+    // Tori with the same levels and minor radius share their VAO, VBO and EBO.
+    std::string GetShapeKey() const;
+
+    // Can be moved (e.g., kept in a std::vector), but not copied.
+    GlGeomTorusLOD(GlGeomTorusLOD&&) = default;
+    GlGeomTorusLOD& operator=(GlGeomTorusLOD&&) = default;
+
+private:
+    // CalcVboAndEbo- return all VBO vertex information, and EBO elements for GL_TRIANGLES drawing.
+    // See GlGeomBase.h for additional information
+    void CalcVboAndEbo(float* VBOdataBuffer, unsigned int* EBOdataBuffer,
+        int vertPosOffset, int vertNormalOffset, int vertTexCoordsOffset,
+        unsigned int stride);
+    void CalcSubRangeElements(unsigned int* EBOdataBuffer, bool calcTexCoords);
+
+    int GetLevelFirstVertex(int sideLevel, int ringLevel, bool calcTexCoords) const;
+    int GetLevelFirstSideStrip(int sideLevel, int ringLevel) const;
+    void CalcVisibleRings(int sideLevel, int ringLevel,
+        const LinearMapR4& modelview, const LinearMapR4& projection);
+
+    GlGeomTorusLOD(const GlGeomTorusLOD&) = delete;
+    GlGeomTorusLOD& operator=(const GlGeomTorusLOD&) = delete;
+
+private:
+    int numLevels;
+    int levelSides[MaxLevels];
+    int levelRings[MaxLevels];
+    float radius;           // Minor radius (major radius is fixed equal to 1.0).
+    double maxPixelError = 0.5;
+    std::vector<int> visibleCounts;     // Ranges of the visible rings of a mesh
+    std::vector<int> visibleStarts;
+};
+
+#endif  // GLGEOM_TORUS_LOD_H
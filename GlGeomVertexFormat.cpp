@@ -0,0 +1,194 @@
+/*
+* GlGeomVertexFormat.cpp - Version 0.9 - October 18, 2026
+*
+* Storage formats for the vertex attributes in the VBO's of the
+*    GlGeomShape classes. See GlGeomVertexFormat.h for more information.
+*
+* An addition to the software accompanying POSSIBLE SECOND EDITION TO the book
+*		3D Computer Graphics: A Mathematical Introduction with OpenGL,
+*		by S. Buss, Cambridge University Press, 2003.
+*   Not part of the book's software, and not written by its author.
+*
+* Software is "as-is" and carries no warranty.  It may be used without
+*   restriction, but if you modify it, please change the filenames to
+*   prevent confusion between different versions.
+* Web page of the book's software: http://math.ucsd.edu/~sbuss/MathCG2
+*/
+
+#include "GlGeomVertexFormat.h"
+#include <math.h>
+#include <string.h>
+#include "assert.h"
+
+void GlGeomVertexLayout::Set(const GlGeomVertexFormat& requested, bool normals, bool texCoords,
+    bool normalsArePositions, bool fitsUnitCube)
+{
+    format = requested;
+    useNormals = normals;
+    useTexCoords = texCoords;
+    splitStreams = requested.splitStreams;
+
+    // Fall back to formats the shape can support
+    if (format.posFormat == GlGeomPosFormat::SNorm16 && !fitsUnitCube) {
+        format.posFormat = GlGeomPosFormat::Float32;
+    }
+    // Float32, not OctSNorm16: a shader written for FromPosition reads a vec3 normal, and does no decoding.
+    if (format.normalFormat == GlGeomNormalFormat::FromPosition && !normalsArePositions) {
+        format.normalFormat = GlGeomNormalFormat::Float32;
+    }
+
+    posOffset = 0;
+    posStride = (format.posFormat == GlGeomPosFormat::Float32) ? 12 : 8;
+    int offset = splitStreams ? 0 : posStride;
+    normalOffset = -1;
+    if (useNormals && format.normalFormat != GlGeomNormalFormat::FromPosition) {
+        normalOffset = offset;
+        offset += (format.normalFormat == GlGeomNormalFormat::Float32) ? 12 : 4;
+    }
+    texOffset = -1;
+    if (useTexCoords) {
+        texOffset = offset;
+        offset += (format.texCoordFormat == GlGeomTexCoordFormat::Float32) ? 8 : 4;
+    }
+    if (splitStreams) {
+        attribStride = offset;
+        stride = posStride + attribStride;
+    }
+    else {
+        stride = offset;
+        posStride = stride;
+        attribStride = stride;
+    }
+    attribStart = 0;            // Set by SetNumVertices()
+}
+
+bool GlGeomVertexLayout::IsAllFloat() const
+{
+    return !splitStreams && format.posFormat == GlGeomPosFormat::Float32
+        && (!useNormals || format.normalFormat == GlGeomNormalFormat::Float32)
+        && (!useTexCoords || format.texCoordFormat == GlGeomTexCoordFormat::Float32);
+}
+
+void GlGeomVertexLayout::PackVertices(const float* src, int numVertices,
+    int srcPosOffset, int srcNormalOffset, int srcTexOffset, int srcStride,
+    void* dst) const
+{
+    assert(srcPosOffset >= 0 && srcStride > 0);
+    assert(normalOffset < 0 || srcNormalOffset >= 0);
+    assert(texOffset < 0 || srcTexOffset >= 0);
+    unsigned char* toPos = (unsigned char*)dst;
+    unsigned char* toVert = toPos + (splitStreams ? (long long)numVertices * posStride : 0);   // Normals and texture coordinates
+    for (int i = 0; i < numVertices; i++, src += srcStride, toPos += posStride, toVert += attribStride) {
+        const float* pos = src + srcPosOffset;
+        if (format.posFormat == GlGeomPosFormat::Float32) {
+            memcpy(toPos + posOffset, pos, 3 * sizeof(float));
+        }
+        else {
+            short* to = (short*)(toPos + posOffset);
+            to[0] = GlGeomFloatToSNorm16(pos[0]);
+            to[1] = GlGeomFloatToSNorm16(pos[1]);
+            to[2] = GlGeomFloatToSNorm16(pos[2]);
+            to[3] = 32767;              // w = 1.0
+        }
+        if (normalOffset >= 0) {
+            const float* n = src + srcNormalOffset;
+            if (format.normalFormat == GlGeomNormalFormat::Float32) {
+                memcpy(toVert + normalOffset, n, 3 * sizeof(float));
+            }
+            else {
+                float u, v;
+                GlGeomOctEncode(n[0], n[1], n[2], &u, &v);
+                short* to = (short*)(toVert + normalOffset);
+                to[0] = GlGeomFloatToSNorm16(u);
+                to[1] = GlGeomFloatToSNorm16(v);
+            }
+        }
+        if (texOffset >= 0) {
+            const float* tc = src + srcTexOffset;
+            switch (format.texCoordFormat) {
+            case GlGeomTexCoordFormat::Float32:
+                memcpy(toVert + texOffset, tc, 2 * sizeof(float));
+                break;
+            case GlGeomTexCoordFormat::Half:
+                ((unsigned short*)(toVert + texOffset))[0] = GlGeomFloatToHalf(tc[0]);
+                ((unsigned short*)(toVert + texOffset))[1] = GlGeomFloatToHalf(tc[1]);
+                break;
+            case GlGeomTexCoordFormat::UNorm16:
+                ((unsigned short*)(toVert + texOffset))[0] = GlGeomFloatToUNorm16(tc[0]);
+                ((unsigned short*)(toVert + texOffset))[1] = GlGeomFloatToUNorm16(tc[1]);
+                break;
+            }
+        }
+    }
+}
+
+// Round to nearest. Values out of range are clamped.
+short GlGeomFloatToSNorm16(float f)
+{
+    f = (f < -1.0f) ? -1.0f : ((f > 1.0f) ? 1.0f : f);
+    return (short)lrintf(f * 32767.0f);
+}
+
+unsigned short GlGeomFloatToUNorm16(float f)
+{
+    f = (f < 0.0f) ? 0.0f : ((f > 1.0f) ? 1.0f : f);
+    return (unsigned short)lrintf(f * 65535.0f);
+}
+
+// IEEE half precision, round to nearest even.
+//    Denormals are flushed to zero, overflow gives infinity.
+//    (Texture coordinates are never very small or very large.)
+unsigned short GlGeomFloatToHalf(float f)
+{
+    unsigned int bits;
+    memcpy(&bits, &f, sizeof(bits));
+    unsigned short sign = (unsigned short)((bits >> 16) & 0x8000);
+    int exponent = (int)((bits >> 23) & 0xff) - 127 + 15;
+    unsigned int mantissa = bits & 0x7fffff;
+    if (((bits >> 23) & 0xff) == 0xff) {
+        return sign | 0x7c00 | (mantissa ? 0x200 : 0);     // Inf or NaN
+    }
+    if (exponent <= 0) {
+        return sign;                                        // Underflow to zero
+    }
+    if (exponent >= 31) {
+        return sign | 0x7c00;                               // Overflow to infinity
+    }
+    unsigned int half = ((unsigned int)exponent << 10) | (mantissa >> 13);
+    unsigned int rest = mantissa & 0x1fff;
+    if (rest > 0x1000 || (rest == 0x1000 && (half & 1))) {
+        half++;                                             // May carry into exponent: still correct
+    }
+    return sign | (unsigned short)half;
+}
+
+// Project onto the octahedron |x|+|y|+|z|=1, and fold the lower half (z<0) over the upper half.
+void GlGeomOctEncode(float x, float y, float z, float* u, float* v)
+{
+    float l1 = fabsf(x) + fabsf(y) + fabsf(z);
+    if (l1 == 0.0f) {
+        *u = 0.0f;
+        *v = 0.0f;
+        return;
+    }
+    x /= l1;
+    y /= l1;
+    if (z < 0.0f) {
+        float xx = (1.0f - fabsf(y)) * (x >= 0.0f ? 1.0f : -1.0f);
+        float yy = (1.0f - fabsf(x)) * (y >= 0.0f ? 1.0f : -1.0f);
+        x = xx;
+        y = yy;
+    }
+    *u = x;
+    *v = y;
+}
+
+const char* GlGeomOctDecodeGlsl =
+"vec3 octDecode(vec2 e)\n"
+"{\n"
+"   vec3 v = vec3(e.x, e.y, 1.0 - abs(e.x) - abs(e.y));\n"
+"   float t = max(-v.z, 0.0);\n"
+"   v.x += (v.x >= 0.0) ? -t : t;\n"
+"   v.y += (v.y >= 0.0) ? -t : t;\n"
+"   return normalize(v);\n"
+"}\n";
@@ -0,0 +1,151 @@
+/*
+* GlGeomVertexFormat.h - Version 0.9 - October 18, 2026
+*
+* Storage formats for the vertex attributes in the VBO's of the
+*    GlGeomShape classes (GlGeomSphere, GlGeomTorus, etc.)
+*
+* By default, a vertex holds 3 floats for the position, 3 floats for
+*    the normal and 2 floats for the texture coordinates (32 bytes).
+*    A GlGeomVertexFormat selects smaller, quantized storage formats:
+*        - positions as normalized 16 bit integers (only for shapes
+*             that fit inside the unit cube [-1,1]^3)
+*        - normals octahedral encoded as two normalized 16 bit integers,
+*             or not stored at all (for the unit sphere, where the
+*             normal is equal to the position)
+*        - texture coordinates as half floats or normalized 16 bit unsigned integers
+*    A GlGeomVertexLayout gives the resulting byte layout of a vertex.
+*
+* The attributes are normally interleaved. With splitStreams, the positions
+*    are in a stream of their own at the start of the VBO, followed by a second
+*    stream with the normals and texture coordinates. A depth-only, shadow or
+*    picking pass then reads only the positions (see GlGeomBase::RenderPositionOnly()).
+*
+* This file does not use OpenGL, so it can be used without an OpenGL context.
+*
+* An addition to the software accompanying POSSIBLE SECOND EDITION TO the book
+*		3D Computer Graphics: A Mathematical Introduction with OpenGL,
+*		by S. Buss, Cambridge University Press, 2003.
+*   Not part of the book's software, and not written by its author.
+*
+* Software is "as-is" and carries no warranty.  It may be used without
+*   restriction, but if you modify it, please change the filenames to
+*   prevent confusion between different versions.
+* Web page of the book's software: http://math.ucsd.edu/~sbuss/MathCG2
+*/
+
+#pragma once
+#ifndef GLGEOM_VERTEX_FORMAT_H
+#define GLGEOM_VERTEX_FORMAT_H
+
+enum class GlGeomPosFormat {
+    Float32,        // 3 floats (12 bytes)
+    SNorm16         // 4 normalized shorts, w = 1.0 (8 bytes). Coordinates must be in [-1,1].
+};
+
+enum class GlGeomNormalFormat {
+    Float32,        // 3 floats (12 bytes)
+    OctSNorm16,     // 2 normalized shorts, octahedral encoded (4 bytes). Decode in the shader.
+    FromPosition    // Not stored: the normal attribute reads the position (0 bytes). Unit sphere only.
+};
+
+enum class GlGeomTexCoordFormat {
+    Float32,        // 2 floats (8 bytes)
+    Half,           // 2 half floats (4 bytes)
+    UNorm16         // 2 normalized unsigned shorts (4 bytes). Coordinates must be in [0,1].
+};
+
+// GlGeomVertexFormat - the requested storage formats.
+//    Requests that a shape cannot support fall back to a format it can support:
+//    SNorm16 positions fall back to Float32 if the shape does not fit in [-1,1]^3;
+//    FromPosition normals fall back to Float32 if the normals are not equal to the positions
+//    (so the shader still reads 3 floats, as it does for FromPosition).
+class GlGeomVertexFormat
+{
+public:
+    GlGeomPosFormat posFormat = GlGeomPosFormat::Float32;
+    GlGeomNormalFormat normalFormat = GlGeomNormalFormat::Float32;
+    GlGeomTexCoordFormat texCoordFormat = GlGeomTexCoordFormat::Float32;
+    bool splitStreams = false;      // Positions in a separate stream from the other attributes
+
+    GlGeomVertexFormat() {}
+    GlGeomVertexFormat(GlGeomPosFormat pos, GlGeomNormalFormat normal, GlGeomTexCoordFormat tex)
+        : posFormat(pos), normalFormat(normal), texCoordFormat(tex) {}
+
+    // The default format: all floats, as in earlier versions.
+    static GlGeomVertexFormat Float() { return GlGeomVertexFormat(); }
+    // The smallest format: 16 bit positions, normals from the positions (or floats), 16 bit texture coordinates.
+    static GlGeomVertexFormat Compact() {
+        return GlGeomVertexFormat(GlGeomPosFormat::SNorm16, GlGeomNormalFormat::FromPosition, GlGeomTexCoordFormat::UNorm16);
+    }
+
+    bool operator==(const GlGeomVertexFormat& other) const {
+        return posFormat == other.posFormat && normalFormat == other.normalFormat
+            && texCoordFormat == other.texCoordFormat && splitStreams == other.splitStreams;
+    }
+    bool operator!=(const GlGeomVertexFormat& other) const { return !(*this == other); }
+};
+
+// GlGeomVertexLayout - the byte layout of one vertex in the VBO.
+//    Offsets and stride are in **bytes**.
+//    normalOffset is -1 if the normals are not stored (not used, or FromPosition).
+//    texOffset is -1 if the texture coordinates are not used.
+//    The position is at posOffset in the position stream, and the normal and texture
+//    coordinates are at normalOffset and texOffset in the attribute stream.
+//    When interleaved, the two streams are the same: attribStart is 0, and
+//    posStride and attribStride are equal to stride.
+class GlGeomVertexLayout
+{
+public:
+    GlGeomVertexFormat format;      // The formats actually used (after any fall backs)
+    bool useNormals = false;
+    bool useTexCoords = false;
+    bool splitStreams = false;
+    int posOffset = 0;
+    int normalOffset = -1;
+    int texOffset = -1;
+    int stride = 12;                // Total bytes per vertex (of both streams)
+    int posStride = 12;             // Stride of the position stream
+    int attribStride = 12;          // Stride of the attribute stream
+    long long attribStart = 0;      // Byte offset of the attribute stream in the VBO data
+
+    // Set the layout. Attributes are packed in the order position, normal, texture coordinates,
+    //   each starting on a 4 byte boundary.
+    //   normalsArePositions - true if the shape's normals are equal to its positions (unit sphere).
+    //   fitsUnitCube - true if all vertex positions lie in [-1,1]^3.
+    void Set(const GlGeomVertexFormat& requested, bool normals, bool texCoords,
+        bool normalsArePositions, bool fitsUnitCube);
+    // SetNumVertices(): With split streams, the attribute stream starts after the positions.
+    void SetNumVertices(int numVertices) {
+        attribStart = splitStreams ? (long long)numVertices * posStride : 0;
+    }
+
+    // True if the layout is exactly the (interleaved) float layout from GlGeomBase::StrideVal() etc.
+    //    Then CalcVboAndEbo can write straight into the VBO.
+    bool IsAllFloat() const;
+
+    int PosComponents() const { return format.posFormat == GlGeomPosFormat::Float32 ? 3 : 4; }
+    int NormalComponents() const { return format.normalFormat == GlGeomNormalFormat::OctSNorm16 ? 2 : 3; }
+    int TexCoordComponents() const { return 2; }
+
+    // Convert tightly strided float vertex data (as returned by CalcVboAndEbo)
+    //    into this layout. Float offsets and stride are in floats, use -1 for
+    //    omitted values, exactly as for CalcVboAndEbo.
+    //    With split streams, the attribute stream is written after numVertices positions.
+    void PackVertices(const float* src, int numVertices,
+        int srcPosOffset, int srcNormalOffset, int srcTexOffset, int srcStride,
+        void* dst) const;
+};
+
+// Conversion helpers, also usable on their own.
+unsigned short GlGeomFloatToHalf(float f);
+short GlGeomFloatToSNorm16(float f);
+unsigned short GlGeomFloatToUNorm16(float f);
+// Octahedral encoding of a unit vector as two values in [-1,1]
+void GlGeomOctEncode(float x, float y, float z, float* u, float* v);
+
+// GLSL source for decoding octahedral normals in a shader.
+//   Paste into a vertex shader and call  "vec3 n = octDecode(vertNormal);"
+//   where vertNormal is declared as "in vec2 vertNormal;"
+extern const char* GlGeomOctDecodeGlsl;
+
+#endif  // GLGEOM_VERTEX_FORMAT_H
@@ -39,6 +39,7 @@
  *   and used in the myRenderScene routine.
  */
 extern unsigned int shaderProgram1;
+extern unsigned int shaderProgramInstanced;
 
 // ***********************************
 // The vertex shaders and fragment shaders allow each
@@ -65,6 +66,24 @@ const char *vertexShader_PosColorXform =
 "   theColor = vertColor;\n"
 "}\0";
 
+// The same, for instanced rendering (GlGeomBase::RenderInstanced).
+//   The modelview matrix, color and scale are per-instance attributes, instead of a
+//   uniform and a fixed attribute. The locations are those of GlGeomInstance in GlGeomInstances.h.
+//   The matrix is a mat4, and uses locations 4 to 7.
+const char *vertexShader_Instanced =
+"#version 330 core\n"
+"layout (location = 0) in vec3 vertPos;	          // Position in attribute location 0\n"
+"layout (location = 4) in mat4 instModelview;     // Per-instance model-view matrix (locations 4-7)\n"
+"layout (location = 8) in vec3 instColor;         // Per-instance color\n"
+"layout (location = 9) in float instScale;        // Per-instance scale\n"
+"out vec3 theColor;					              // Output a color to the fragment shader\n"
+"uniform mat4 projectionMatrix;		              // The projection matrix\n"
+"void main()\n"
+"{\n"
+"   gl_Position = projectionMatrix * instModelview * vec4(instScale * vertPos, 1.0);\n"
+"   theColor = instColor;\n"
+"}\0";
+
 // Set a general color using a fragment shader. (A "fragment" is usually a "pixel".)
 //    The color value is passed in, obtained from the color(s) on the vertice(s).
 //    Color values range from 0.0 to 1.0.
@@ -86,6 +105,8 @@ void setup_shaders() {
 	// A very simple shader program: has transformations, but no lighting and no texture coordinates.
 	//      Has a position and color for each vertex. 
 	shaderProgram1 = setup_shader_vertfrag(vertexShader_PosColorXform, fragmentShader_ColorOnly);
+	// The same, with the modelview matrix and color given per instance.
+	shaderProgramInstanced = setup_shader_vertfrag(vertexShader_Instanced, fragmentShader_ColorOnly);
 }
 
 /*
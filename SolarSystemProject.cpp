@@ -13,6 +13,8 @@
  *    Press "t" or "T" key to toggle between animating at a fixed time step
  *                                     or at real elapsed time.
  *    Press "c" or "C" to toggle culling backfaces
+ *    Press "m" or "M" to toggle submitting the whole scene with multi-draw indirect
+ *    Press "l" or "L" to switch between 4 and 5 levels of detail, re-meshed in the background
  *    The up arrow key and down array key control the
  *			time step used in the animation rate.  Each key
  *			press multiplies or divides the times by a factor 
@@ -47,14 +49,21 @@
 #include <GLFW/glfw3.h>
 
 #include "LinearR4.h"		
-#include "GlGeomSphere.h"
+#include "GlGeomSphereLOD.h"
 #include "GlGeomTorus.h"
+#include "GlGeomStagingRing.h"
+#include "GlGeomMeshCache.h"
+#include "GlGeomDrawBuilder.h"
+#include "GlGeomStateCache.h"
+#include "GlGeomLoader.h"
+#include "GlGeomBudget.h"
 #include "ShaderMgrSLR.h"
 bool check_for_opengl_errors();     // Function prototype (should really go in a header file)
 
 // Enable standard input and output via printf(), etc.
 // Put this include *after* the includes for glew and GLFW!
 #include <stdio.h>
+#include <string>
 
 // ********************
 // Animation controls and state infornation
@@ -65,6 +74,7 @@ bool spinMode = true;
 bool singleStep = false;
 bool cullBackFaces = false; // Equals true to cull backfaces. Equals false to not cull backfaces.   
 bool UseRealTime = false;   // Initially use a fixed animation increment step.
+bool useMultiDraw = false;  // Equals true to submit all the bodies and the ring with a GlGeomDrawBuilder
 double PreviousTime = 0.0;
 
 // These three variables control the animation's state and speed.
@@ -82,12 +92,22 @@ LinearMapR4 viewMatrix;		// The current view matrix, based on viewAzimuth and vi
 // ***********************
 
 // These objects take care of generating and loading VAO's, VBO's and EBO's,
-//    rendering spheres for the moon, earch and sun.
+//    rendering spheres for the moons, planets and suns.
 // They render as radius 1 spheres (but will be scaled by the Model matrix)
-GlGeomSphere Moon1(6, 6);    // A sphere with 6 slices and 6 stacks
-GlGeomSphere Earth(8, 12);    // A sphere with 8 slices and 12 stacks
-GlGeomSphere Sun(10, 10);    // A sphere with 10 slices and 10 stacks
+// The spheres are all drawn from one GlGeomSphereLOD, with a level of
+//    detail chosen by the size of each body on the screen.
+// Pressing 'l' re-meshes the spheres in the background with GlGeomLoader,
+//    and the old mesh is rendered until the new one has loaded.
+GlGeomSphereLOD Spheres(4, 6, 4);   // Levels 6x4, 12x8, 24x16 and 48x32 (slices x stacks)
+GlGeomLoader* Loader = nullptr;
+GlGeomBudget MeshBudget(64 << 20);  // Keeps track of the VBO's and EBO's (64 MB)
+GlGeomLodState FirstSunLod, SecondSunLod, PlanetXLod, EarthLod, MoonLod, MoonletLod;
+GlGeomInstanceBuffer SunInstances;  // The suns' matrices and colors, for instanced rendering
+GlGeomInstanceBuffer SceneInstances;    // In multi-draw mode: the matrices and colors of everything,
+GlGeomDrawBuilder SceneDraws;           //     and one draw per object (one API call per VAO)
 GlGeomTorus Ring(8, 20, 0.02f);  // A torus with 20 rings, each with 8 sides.  Minor radius 0.02.
+static constexpr ConstTorusMesh<8, 20> RingMesh{ 0.02f };     // Its mesh, calculated at compile time
+std::string MeshCacheFile = "SolarSystem.meshcache";     // Put next to the executable by main()
 
 // We create one shader program: consisting of a vertex shader and a fragment shader
 unsigned int shaderProgram1;
@@ -97,10 +117,14 @@ const char* projMatName = "projectionMatrix";		// Name of the uniform variable p
 int projMatLocation;						// Location of the projectionMatrix in the "smooth" shader program.
 const char* modelviewMatName = "modelviewMatrix";	// Name of the uniform variable modelviewMatrix
 int modelviewMatLocation;					// Location of the modelviewMatrix in the "smooth" shader program.
+// A second shader program, for instanced rendering: the modelview matrix and color are per-instance attributes.
+unsigned int shaderProgramInstanced;
+int instProjMatLocation;				// Location of the projectionMatrix in the instanced shader program.
 
 //  The Projection matrix: Controls the "camera view/field-of-view" transformation
 //     Generally is the same for all objects in the scene.
 LinearMapR4 theProjectionMatrix;		//  The Projection matrix: Controls the "camera/view" transformation
+int viewportHeight = 1;                 //  Height of the viewport in pixels (for choosing levels of detail)
 
 // A ModelView matrix controls the placement of a particular object in 3-space.
 //     It is generally different for each object.
@@ -140,17 +164,49 @@ void setViewMatrix() {
 // *************************
 void mySetupGeometries() {
 
+    // Keep track of the buffer memory.  Nothing is evictable, since every
+    //    mesh is drawn in every frame.
+    GlGeomBudget::SetDefault(&MeshBudget);
+
+    // The spheres are unit spheres, so can use 16 bit vertex positions.
+    Spheres.SetVertexFormat(GlGeomVertexFormat::Compact());
+
+    // The meshes are kept in a cache file, so they are only calculated on the first run.
+    GlGeomMeshCache meshCache(MeshCacheFile.c_str());
+    GlGeomMeshCache::SetDefault(&meshCache);
+
+    Ring.SetConstMesh(RingMesh);
+
 	// These routines take care of loading info into their VAO's, VBO's and EBO's.
-	Sun.InitializeAttribLocations(vertPos_loc);
-	Earth.InitializeAttribLocations(vertPos_loc);
-    Moon1.InitializeAttribLocations(vertPos_loc);
+    Spheres.InitializeAttribLocations(vertPos_loc);
     Ring.InitializeAttribLocations(vertPos_loc);
 
+    meshCache.Save();       // Only writes the file if meshes were added
+    GlGeomMeshCache::SetDefault(nullptr);
+
     setViewMatrix(); // Set the initial view matrix
 
 	check_for_opengl_errors();   // Really a great idea to check for errors -- esp. good for debugging!
 }
 
+// *************************************
+// Render one of the spheres, with a level of detail chosen from its size on the screen.
+//    In multi-draw mode, it is added to SceneDraws instead, to be rendered
+//    with everything else at the end of myRenderScene().
+// *************************************
+void renderSphere(const LinearMapR4& matrix, float red, float green, float blue, GlGeomLodState* lod) {
+	if (useMultiDraw) {
+		int level = Spheres.SelectLevel(GlGeomProjectedRadius(matrix, theProjectionMatrix, viewportHeight), lod);
+		SceneDraws.Add(Spheres, SceneInstances.GetNumInstances(), 1, level);
+		SceneInstances.Add(matrix, red, green, blue);
+		return;
+	}
+	matrix.DumpByColumns(matEntries);
+	glUniformMatrix4fv(modelviewMatLocation, 1, false, matEntries);
+	GlGeomStateCache::VertexAttrib3f(vertColor_loc, red, green, blue);
+	Spheres.Render(matrix, theProjectionMatrix, viewportHeight, lod);
+}
+
 // *************************************
 // Main routine for rendering the scene
 // myRenderScene() is called every time the scene needs to be redrawn.
@@ -191,7 +247,14 @@ void myRenderScene() {
     }
 
 
-	glUseProgram(shaderProgram1);
+	MeshBudget.BeginFrame();
+
+	// The spheres take over their new mesh once it has loaded.
+	Loader->Poll();
+
+	GlGeomStateCache::UseProgram(shaderProgram1);
+	SceneInstances.Clear();
+	SceneDraws.Clear();
 
 	/* ********************************************************************************* */
 	/**************************** Start of Objects to Render *************************** */
@@ -214,10 +277,6 @@ void myRenderScene() {
 	FirstSunMatrix.Mult_glRotate(sunRotationAngle, 0.0, 1.0, 0.0);
 	FirstSunMatrix.Mult_glTranslate(0.0, 0.0, 0.84);
 	FirstSunMatrix.Mult_glScale(0.7);
-	FirstSunMatrix.DumpByColumns(matEntries);
-	glUniformMatrix4fv(modelviewMatLocation, 1, false, matEntries);
-	glVertexAttrib3f(vertColor_loc, 1.0f, 1.0f, 0.0f);
-	Sun.Render();
 
 
 	// set up the second Sun
@@ -225,10 +284,25 @@ void myRenderScene() {
 	SecondSunMatrix.Mult_glRotate(sunRotationAngle, 0.0, 1.0, 0.0);
 	SecondSunMatrix.Mult_glTranslate(0.0, 0.0, -0.85);
 	SecondSunMatrix.Mult_glScale(0.7);
-	SecondSunMatrix.DumpByColumns(matEntries);
-	glUniformMatrix4fv(modelviewMatLocation, 1, false, matEntries);
-	glVertexAttrib3f(vertColor_loc, 1.0f, 1.0f, 0.0f);
-	Sun.Render();
+
+	// Both suns are rendered with one instanced draw call, at the finer of their levels of detail.
+	// (In multi-draw mode, they are rendered with everything else.)
+	if (useMultiDraw) {
+		renderSphere(FirstSunMatrix, 1.0f, 1.0f, 0.0f, &FirstSunLod);
+		renderSphere(SecondSunMatrix, 1.0f, 1.0f, 0.0f, &SecondSunLod);
+	}
+	else {
+		SunInstances.Clear();
+		SunInstances.Add(FirstSunMatrix, 1.0f, 1.0f, 0.0f);     // Make the suns yellow
+		SunInstances.Add(SecondSunMatrix, 1.0f, 1.0f, 0.0f);
+		SunInstances.Upload();
+		int sunLevel = Max(
+			Spheres.SelectLevel(GlGeomProjectedRadius(FirstSunMatrix, theProjectionMatrix, viewportHeight), &FirstSunLod),
+			Spheres.SelectLevel(GlGeomProjectedRadius(SecondSunMatrix, theProjectionMatrix, viewportHeight), &SecondSunLod));
+		GlGeomStateCache::UseProgram(shaderProgramInstanced);
+		Spheres.RenderLevelInstanced(sunLevel, SunInstances.GetNumInstances(), SunInstances.GetBuffer());
+		GlGeomStateCache::UseProgram(shaderProgram1);
+	}
 
 
 	// set up PlanetX which orbits the Sun
@@ -237,10 +311,7 @@ void myRenderScene() {
 	PlanetXMatrix.Mult_glRotate(planetXRevolveAngle, 0.0, -1.0, 0.0);	// rotates clockwise
 	PlanetXMatrix.Mult_glTranslate(0.0, 0.0, 6.0);
 	PlanetXMatrix.Mult_glScale(0.3);
-	PlanetXMatrix.DumpByColumns(matEntries);
-	glUniformMatrix4fv(modelviewMatLocation, 1, false, matEntries);
-	glVertexAttrib3f(vertColor_loc, 1.0f, 0.5f, 1.0f);
-	Earth.Render();
+	renderSphere(PlanetXMatrix, 1.0f, 0.5f, 1.0f, &PlanetXLod);
     
     // EarthPosMatrix - specifies position of the earth (EARTH SYSTEM)
     // EarthMatrix - specifies the size of the earth and its rotation on its axis (EARTH ITSELF)
@@ -256,19 +327,22 @@ void myRenderScene() {
     double earthRotationAngle = (HourOfDay / 24.0) * PI2;
     EarthMatrix.Mult_glRotate(earthRotationAngle, 0.0, 1.0, 0.0);	// Rotate earth on y-axis
 	EarthMatrix.Mult_glScale(0.5);	// Make radius 0.5.
-	EarthMatrix.DumpByColumns(matEntries);
-	glUniformMatrix4fv(modelviewMatLocation, 1, false, matEntries);
-	glVertexAttrib3f(vertColor_loc, 0.2f, 0.4f, 1.0f);	// Make the earth bright cyan-blue
-	Earth.Render();
+	renderSphere(EarthMatrix, 0.2f, 0.4f, 1.0f, &EarthLod);	// Make the earth bright cyan-blue
 
 
 	// The ring (torus) around the sun.
 	LinearMapR4 RingMatrix = EarthPosMatrix;	// place the torus around the Earth
 	RingMatrix.Mult_glScale(1.0);
-	RingMatrix.DumpByColumns(matEntries);
-	glUniformMatrix4fv(modelviewMatLocation, 1, false, matEntries);
-	glVertexAttrib3f(vertColor_loc, 1.0f, 0.0f, 0.0f);     // Make the ring red
-	Ring.Render();
+	if (useMultiDraw) {
+		SceneDraws.Add(Ring, SceneInstances.GetNumInstances(), 1);
+		SceneInstances.Add(RingMatrix, 1.0f, 0.0f, 0.0f);     // Make the ring red
+	}
+	else {
+		RingMatrix.DumpByColumns(matEntries);
+		glUniformMatrix4fv(modelviewMatLocation, 1, false, matEntries);
+		GlGeomStateCache::VertexAttrib3f(vertColor_loc, 1.0f, 0.0f, 0.0f);     // Make the ring red
+		Ring.RenderCulled(RingMatrix, theProjectionMatrix);
+	}
 
 
     // MoonMatrix - control placement, and size of the moon.
@@ -277,10 +351,7 @@ void myRenderScene() {
     MoonMatrix.Mult_glRotate(moonRotationAngle, 0.0, 1.0, 0.0);  // Revolving around the earth twelve times per year
 	MoonMatrix.Mult_glTranslate(0.0, 0.0, 1.0);	    // Place the Moon one unit away from the earth
     MoonMatrix.Mult_glScale(0.2);                   // Moon has radius 0.2
-    MoonMatrix.DumpByColumns(matEntries);
-	glUniformMatrix4fv(modelviewMatLocation, 1, false, matEntries);
-	glVertexAttrib3f(vertColor_loc, 0.9f, 0.9f, 0.9f);     // Make the moon bright gray
-	Moon1.Render();
+	renderSphere(MoonMatrix, 0.9f, 0.9f, 0.9f, &MoonLod);     // Make the moon bright gray
 
 
 	// MoonletMatrix - control placement, and size of the moonlet
@@ -289,16 +360,21 @@ void myRenderScene() {
 	MoonletMatrix.Mult_glRotate(moonletRotationAngle, 0.0, 1.0, 0.0);  // Revolving around the earth twelve times per year
 	MoonletMatrix.Mult_glTranslate(0.0, 0.0, 1.5);	    // Place the Moon one unit away from the earth
 	MoonletMatrix.Mult_glScale(0.3);                   // Moon has radius 0.2
-	MoonletMatrix.DumpByColumns(matEntries);
-	glUniformMatrix4fv(modelviewMatLocation, 1, false, matEntries);
-	glVertexAttrib3f(vertColor_loc, 0.0f, 1.0f, 0.0f);     // Make the moon bright gray
-	Moon1.Render();
+	renderSphere(MoonletMatrix, 0.0f, 1.0f, 0.0f, &MoonletLod);     // Make the moon bright gray
 
 
 	/* ******************************************************************************************** */
 	/* *************************** End of Objects to Render *************************************** */
 	/* ******************************************************************************************** */
 
+	// In multi-draw mode, everything is rendered now: one call for the spheres, and one for the ring.
+	if (useMultiDraw) {
+		SceneInstances.Upload();
+		GlGeomStateCache::UseProgram(shaderProgramInstanced);
+		SceneDraws.Submit(SceneInstances.GetBuffer());
+		GlGeomStateCache::UseProgram(shaderProgram1);
+	}
+
 
 
 	check_for_opengl_errors();   // Really a great idea to check for errors -- esp. good for debugging!
@@ -311,6 +387,7 @@ void my_setup_SceneData() {
 	// Get the locations of the projection and model view matrices in the shader programs.
 	projMatLocation = glGetUniformLocation(shaderProgram1, projMatName);
 	modelviewMatLocation = glGetUniformLocation(shaderProgram1, modelviewMatName);
+	instProjMatLocation = glGetUniformLocation(shaderProgramInstanced, projMatName);
 
     // Initialize for animation (not really necessary)
     glfwSetTime(PreviousTime);     // PreviousTime is equal to 0.0 when this line reached.
@@ -348,13 +425,21 @@ void key_callback(GLFWwindow* window, int key, int scancode, int action, int mod
         break;
     case GLFW_KEY_C:		// Toggle backface culling
         cullBackFaces = !cullBackFaces;     // Negate truth value of cullBackFaces
-        if (cullBackFaces) {
-            glEnable(GL_CULL_FACE);
-        }
-        else {
-            glDisable(GL_CULL_FACE);
+        GlGeomStateCache::SetCullFace(cullBackFaces);
+        // When back faces are culled, whole back facing meshlets can be skipped on the CPU.
+        Spheres.SetUseMeshlets(cullBackFaces);
+        Spheres.SetVisibleOnly(cullBackFaces);     // The far side is only hidden when back faces are culled
+        Ring.SetUseMeshlets(cullBackFaces);
+        break;
+    case GLFW_KEY_L:		// Re-mesh the spheres in the background, with one level more or less
+        if (!Spheres.IsRemeshing()) {
+            int levels = (Spheres.GetNumLevels() == 4) ? 5 : 4;
+            Loader->Remesh(Spheres, [levels](GlGeomSphereLOD& s) { s.Remesh(levels, 6, 4); });
         }
         break;
+    case GLFW_KEY_M:		// Toggle multi-draw mode
+        useMultiDraw = !useMultiDraw;
+        break;
     case GLFW_KEY_T:		// Toggle using real time versus fixed time step
         UseRealTime = !UseRealTime;
         if (UseRealTime) {
@@ -396,6 +481,7 @@ void key_callback(GLFWwindow* window, int key, int scancode, int action, int mod
 void window_size_callback(GLFWwindow* window, int width, int height) {
 	// Define the portion of the window used for OpenGL rendering.
 	glViewport(0, 0, width, height);
+    viewportHeight = (height == 0) ? 1 : height;
 
 	// Setup the projection matrix as a perspective view.
 	// The complication is that the aspect ratio of the window may not match the
@@ -419,20 +505,24 @@ void window_size_callback(GLFWwindow* window, int width, int height) {
     double zNear = Max(CameraDistance - Zmax, ZnearMin);
 	theProjectionMatrix.Set_glFrustum(-windowXmax, windowXmax, -windowYmax, windowYmax, zNear, zFar);
 
+	theProjectionMatrix.DumpByColumns(matEntries);
 	if (glIsProgram(shaderProgram1)) {
-		glUseProgram(shaderProgram1);
-		theProjectionMatrix.DumpByColumns(matEntries);
+		GlGeomStateCache::UseProgram(shaderProgram1);
 		glUniformMatrix4fv(projMatLocation, 1, false, matEntries);
 	}
+	if (glIsProgram(shaderProgramInstanced)) {
+		GlGeomStateCache::UseProgram(shaderProgramInstanced);
+		glUniformMatrix4fv(instProjMatLocation, 1, false, matEntries);
+	}
 	check_for_opengl_errors();   // Really a great idea to check for errors -- esp. good for debugging!
 }
 
 void my_setup_OpenGL() {
 	
-	glEnable(GL_DEPTH_TEST);	// Enable depth buffering
-	glDepthFunc(GL_LEQUAL);		// Useful for multipass shaders
-    glPolygonMode(GL_FRONT_AND_BACK, GL_LINE);
-    glCullFace(GL_BACK);        // GL_BACK is the default anyway
+    GlGeomStateCache::SetDepthTest(true);   // Enable depth buffering
+    GlGeomStateCache::DepthFunc(GL_LEQUAL); // Useful for multipass shaders
+    GlGeomStateCache::PolygonMode(GL_LINE);
+    GlGeomStateCache::CullFace(GL_BACK);    // GL_BACK is the default anyway
 
 	check_for_opengl_errors();   // Really a great idea to check for errors -- esp. good for debugging!
 }
@@ -455,7 +545,16 @@ void setup_callbacks(GLFWwindow* window) {
 	// glfwSetMouseButtonCallback(window, mouse_button_callback);
 }
 
-int main() {
+int main(int argc, char* argv[]) {
+    // The mesh cache file is kept in the executable's directory, not the current directory.
+    if (argc > 0 && argv[0] != nullptr) {
+        std::string exePath(argv[0]);
+        size_t slash = exePath.find_last_of("/\\");
+        if (slash != std::string::npos) {
+            MeshCacheFile = exePath.substr(0, slash + 1) + MeshCacheFile;
+        }
+    }
+
 	glfwSetErrorCallback(error_callback);	// Supposed to be called in event of errors. (doesn't work?)
 	glfwInit();
 	//glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
@@ -495,11 +594,14 @@ int main() {
     printf("Press up and down arrow keys to increase and decrease animation rate.\n   ");
     printf("    - animation step size is doubled or halved with each press.\n");
 	printf("Press 'c' or 'C' (Cull) to toggle whether back faces are culled.\n");
+	printf("Press 'm' or 'M' (Multi-draw) to toggle drawing the whole scene with one multi-draw per VAO.\n");
+	printf("Press 'l' or 'L' (Levels) to switch between 4 and 5 levels of detail, re-meshed in the background.\n");
 	printf("Press ESCAPE to exit.\n");
 	
     setup_callbacks(window);
    
 	// Initialize OpenGL, the scene and the shaders
+    Loader = new GlGeomLoader(window);     // Re-meshes spheres on a background thread
     my_setup_OpenGL();
 	my_setup_SceneData();
  	window_size_callback(window, initWidth, initHeight);
@@ -516,6 +618,8 @@ int main() {
 		// glfwPollEvents();					// Use this version when animating as fast as possible
 	}
 
+	delete Loader;						// Waits for any loads, and closes the loader's context
+	GlGeomStagingRing::DeleteDefault();	// Release the upload buffer while the context exists
 	glfwTerminate();
 	return 0;
 }